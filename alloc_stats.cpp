@@ -0,0 +1,79 @@
+#include "alloc_stats.hpp"
+
+#ifdef VIDEO2ASCII_ALLOC_STATS
+
+#include <cstdlib>
+#include <new>
+
+/* --- Counters --- */
+
+namespace {
+
+thread_local AllocSample tlsAllocs;
+
+void* countedAlloc(std::size_t size) {
+    tlsAllocs.count++;
+    tlsAllocs.bytes += size;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* countedAlignedAlloc(std::size_t size, std::align_val_t align) {
+    tlsAllocs.count++;
+    tlsAllocs.bytes += size;
+    const auto a = static_cast<std::size_t>(align);
+    void* p = nullptr;
+    if (posix_memalign(&p, a < sizeof(void*) ? sizeof(void*) : a, size == 0 ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return p;
+}
+
+void* throwingAlloc(void* p) {
+    if (!p) { throw std::bad_alloc(); }
+    return p;
+}
+
+}
+
+bool allocStatsEnabled() { return true; }
+AllocSample threadAllocs() { return tlsAllocs; }
+
+/* --- Global Operator Replacements --- */
+
+void* operator new(std::size_t size) { return throwingAlloc(countedAlloc(size)); }
+void* operator new[](std::size_t size) { return throwingAlloc(countedAlloc(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return throwingAlloc(countedAlignedAlloc(size, align));
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    return throwingAlloc(countedAlignedAlloc(size, align));
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, align);
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, align);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+
+#else
+
+bool allocStatsEnabled() { return false; }
+AllocSample threadAllocs() { return AllocSample{}; }
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocation accounting. When built with VIDEO2ASCII_ALLOC_STATS the
+// global operator new/delete are replaced with counting versions; otherwise
+// allocStatsEnabled() is false and every sample is zero. Counts are kept per
+// thread so each pipeline stage is charged only for its own allocations.
+
+struct AllocSample {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+
+    AllocSample& operator+=(const AllocSample& o) {
+        count += o.count;
+        bytes += o.bytes;
+        return *this;
+    }
+    AllocSample operator-(const AllocSample& o) const {
+        return AllocSample{count - o.count, bytes - o.bytes};
+    }
+};
+
+bool allocStatsEnabled();
+
+// Allocations made by the calling thread since it started
+AllocSample threadAllocs();
@@ -0,0 +1,199 @@
+#include "ascii.hpp"
+
+#include <cstring>
+
+/* --- Helpers --- */
+
+namespace {
+
+// Body for cv::parallel_for_ (a loop body object rather than a lambda, so
+// dispatching it never allocates)
+class RowBandEncoder : public cv::ParallelLoopBody {
+public:
+    RowBandEncoder(const cv::Mat& resized, ColorMode mode, std::vector<std::string>& segments)
+        : resized_(resized), mode_(mode), segments_(segments) {}
+
+    void operator()(const cv::Range& range) const override {
+        const int bands = static_cast<int>(segments_.size());
+        const int height = resized_.rows;
+        for (int i = range.start; i < range.end; i++) {
+            convertRows(resized_, mode_, i * height / bands, (i + 1) * height / bands,
+                segments_[i]);
+        }
+    }
+
+private:
+    const cv::Mat& resized_;
+    ColorMode mode_;
+    std::vector<std::string>& segments_;
+};
+
+// Cell writers for convertRows: each writes one whole cell at `p` and
+// returns the end. The buffer has room for the longest cell, so the
+// fixed-size copies may run past a shorter cell; the next write covers it.
+constexpr size_t ANSI_CODE_LEN = sizeof("\x1b[30m") - 1;     // Every 8-color code
+constexpr size_t RESET_LEN = sizeof("\x1b[0m") - 1;
+constexpr size_t TRUECOLOR_LEN = sizeof("\x1b[38;2;") - 1;
+
+// Text cells in full color are the brightest a frame cell can be
+constexpr char TEXT_TRUECOLOR[] = "\x1b[38;2;255;255;255m";
+
+char* writeAnsiCell(char* p, int r, int g, int b, int brightness) {
+    std::memcpy(p, rgbToAnsiColor(r, g, b, brightness), ANSI_CODE_LEN);
+    p += ANSI_CODE_LEN;
+    *p++ = brightnessToAscii(brightness);
+    std::memcpy(p, Color::RESET, RESET_LEN);
+    return p + RESET_LEN;
+}
+
+char* writeDecimal(char* p, int v) {
+    const ByteDecimal& d = BYTE_DECIMALS[v];
+    std::memcpy(p, d.text, sizeof(d.text));
+    return p + d.len;
+}
+
+char* writeTrueColorCell(char* p, int r, int g, int b, int brightness) {
+    std::memcpy(p, Color::TRUECOLOR, TRUECOLOR_LEN);
+    p = writeDecimal(p + TRUECOLOR_LEN, r);
+    *p++ = ';';
+    p = writeDecimal(p, g);
+    *p++ = ';';
+    p = writeDecimal(p, b);
+    *p++ = 'm';
+    *p++ = brightnessToAscii(brightness);
+    std::memcpy(p, Color::RESET, RESET_LEN);
+    return p + RESET_LEN;
+}
+
+// `buffer`, or a view of its top-left corner when it is larger than `size`,
+// so a smaller image (a crop, a box-reduced frame) is written into pooled
+// scratch rather than replacing it. `corner` holds the view.
+cv::Mat& scratch(cv::Mat& buffer, cv::Mat& corner, cv::Size size, int type) {
+    if (buffer.type() != type || buffer.size() == size ||
+        buffer.cols < size.width || buffer.rows < size.height) {
+        return buffer;
+    }
+    corner = buffer(cv::Rect(0, 0, size.width, size.height));
+    return corner;
+}
+
+}
+
+/* --- Function Definitions --- */
+
+void resizeFrame(const cv::Mat& frame, cv::Mat& resized, cv::Mat& gray,
+        ColorMode mode, cv::Size size) {
+    if (mode == ColorMode::ANSI || mode == ColorMode::Full) {
+        cv::resize(frame, resized, size, 0, 0, cv::INTER_AREA);
+    } else {
+        cv::Mat corner;
+        cv::Mat& luma = scratch(gray, corner, frame.size(), CV_8UC1);
+        cv::cvtColor(frame, luma, cv::COLOR_BGR2GRAY);
+        cv::resize(luma, resized, size, 0, 0, cv::INTER_AREA);
+    }
+}
+
+void resizeFrame(const cv::Mat& frame, cv::Mat& resized, cv::Mat& gray, cv::Mat& reduced,
+        ColorMode mode, cv::Size size, ResizeMethod method) {
+    const int factor = pyramidFactor(frame.size(), size, method);
+    if (factor == 1) {
+        resizeFrame(frame, resized, gray, mode, size);
+        return;
+    }
+
+    cv::Mat boxCorner;
+    cv::Mat& box = scratch(reduced, boxCorner,
+        cv::Size(frame.cols / factor, frame.rows / factor), CV_8UC3);
+    boxReduce(frame, box, factor);
+    if (mode == ColorMode::ANSI || mode == ColorMode::Full) {
+        cv::resize(box, resized, size, 0, 0, cv::INTER_AREA);
+        return;
+    }
+
+    // Luma of the reduced image only
+    cv::Mat lumaCorner;
+    cv::Mat& luma = scratch(gray, lumaCorner, box.size(), CV_8UC1);
+    cv::cvtColor(box, luma, cv::COLOR_BGR2GRAY);
+    cv::resize(luma, resized, size, 0, 0, cv::INTER_AREA);
+}
+
+size_t maxFrameBytes(ColorMode mode, int width, int height) {
+    // Longest cells: "\x1b[90m" + glyph + "\x1b[0m" and
+    // "\x1b[38;2;255;255;255m" + glyph + "\x1b[0m"
+    size_t cell = 1;
+    if (mode == ColorMode::ANSI) { cell = 5 + 1 + 4; }
+    if (mode == ColorMode::Full) { cell = 19 + 1 + 4; }
+    return (static_cast<size_t>(width) * cell + 1) * static_cast<size_t>(height);
+}
+
+void convertText(const char* text, size_t len, ColorMode mode, std::string& out) {
+    if (mode == ColorMode::None) {
+        out.append(text, len);
+        return;
+    }
+
+    // One color code for the run rather than one per cell; the glyphs are
+    // text, not brightness, so the color does not vary along it
+    out += (mode == ColorMode::ANSI) ? Color::BRIGHT_WHITE : TEXT_TRUECOLOR;
+    out.append(text, len);
+    out += Color::RESET;
+}
+
+size_t maxTextBytes(ColorMode mode, size_t len) {
+    if (mode == ColorMode::None) { return len; }
+    const size_t code = (mode == ColorMode::ANSI) ? ANSI_CODE_LEN : sizeof(TEXT_TRUECOLOR) - 1;
+    return code + len + RESET_LEN;
+}
+
+void convertRows(const cv::Mat& resized, ColorMode mode, int rowBegin, int rowEnd,
+        std::string& out) {
+    const int width = resized.cols;
+    const size_t rowMax = maxFrameBytes(mode, width, 1);
+
+    // Size `out` for the worst case once, write the rows through a raw
+    // pointer, and trim once at the end. That drops the capacity check per
+    // appended piece. `out` is not cleared first, so a buffer reused across
+    // frames only zero-fills the slack past the previous frame's length.
+    out.resize(rowMax * static_cast<size_t>(rowEnd - rowBegin));
+    char* p = out.data();
+
+    for (int y = rowBegin; y < rowEnd; y++) {
+        if (mode == ColorMode::None) {
+            const uchar* row = resized.ptr<uchar>(y);
+            for (int x = 0; x < width; x++) { *p++ = brightnessToAscii(row[x]); }
+        } else {
+            const cv::Vec3b* row = resized.ptr<cv::Vec3b>(y);
+            for (int x = 0; x < width; x++) {
+                const int b = row[x][0], g = row[x][1], r = row[x][2];
+                const int brightness = (r + g + b) / 3;
+                p = (mode == ColorMode::ANSI)
+                    ? writeAnsiCell(p, r, g, b, brightness)
+                    : writeTrueColorCell(p, r, g, b, brightness);
+            }
+        }
+        *p++ = '\n';
+    }
+    out.resize(static_cast<size_t>(p - out.data()));
+}
+
+void convertFrame(const cv::Mat& resized, ColorMode mode, std::string& out) {
+    convertRows(resized, mode, 0, resized.rows, out);
+}
+
+void convertFrameBands(const cv::Mat& resized, ColorMode mode,
+        std::vector<std::string>& segments) {
+    const RowBandEncoder encoder(resized, mode, segments);
+    const int bands = static_cast<int>(segments.size());
+
+    if (bands == 1) {
+        encoder(cv::Range(0, 1));
+    } else {
+        cv::parallel_for_(cv::Range(0, bands), encoder, bands);
+    }
+}
+
+std::string convertFrame(const cv::Mat& resized, ColorMode mode) {
+    std::string out;
+    convertFrame(resized, mode, out);
+    return out;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "downscale.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+/* --- Global Constants --- */
+
+constexpr char asciiChars[] = {'@', '%', '#', '*', '+', '=', '-', ':', '.', ' '};
+constexpr int asciiLen = sizeof(asciiChars);
+
+enum class ColorMode : uint8_t {
+    None,
+    ANSI,
+    Full
+};
+
+namespace Color {
+    constexpr const char* BLACK = "\x1b[30m";
+    constexpr const char* RED   = "\x1b[31m";
+    constexpr const char* GREEN = "\x1b[32m";
+    constexpr const char* BLUE  = "\x1b[34m";
+    constexpr const char* WHITE = "\x1b[37m";
+
+    constexpr const char* BRIGHT_BLACK = "\x1b[90m";
+    constexpr const char* BRIGHT_RED   = "\x1b[91m";
+    constexpr const char* BRIGHT_GREEN = "\x1b[92m";
+    constexpr const char* BRIGHT_BLUE  = "\x1b[94m";
+    constexpr const char* BRIGHT_WHITE = "\x1b[97m";
+
+    constexpr const char* TRUECOLOR = "\x1b[38;2;";
+    constexpr const char* RESET = "\x1b[0m";
+
+    constexpr int DARK_THRESHOLD = 30;
+    constexpr int GRAYSCALE_VARIANCE = 20;
+    constexpr int VERY_BRIGHT = 200;
+    constexpr int BRIGHT = 120;
+    constexpr int MEDIUM_BRIGHT = 128;
+}
+
+/* --- Function Prototypes --- */
+
+// Downscale a decoded BGR frame to the character grid. Writes a BGR image to
+// `resized` for color modes, or a single channel luma image otherwise; `gray`
+// is scratch space reused across calls. `frame` may be a view into a larger
+// image (a crop); scratch larger than needed is used from its corner.
+void resizeFrame(const cv::Mat& frame, cv::Mat& resized, cv::Mat& gray,
+        ColorMode mode, cv::Size size);
+
+// As above, but downscaling by `method` (see downscale.hpp); `reduced` is
+// scratch for the pyramid's output. ResizeMethod::Area matches the overload
+// above exactly.
+void resizeFrame(const cv::Mat& frame, cv::Mat& resized, cv::Mat& gray, cv::Mat& reduced,
+        ColorMode mode, cv::Size size, ResizeMethod method);
+
+// Encode a resized frame (as produced by resizeFrame) into terminal text.
+// The overload taking `out` replaces its contents but keeps its capacity, so
+// a buffer reused across frames stops allocating after the first one.
+void convertFrame(const cv::Mat& resized, ColorMode mode, std::string& out);
+std::string convertFrame(const cv::Mat& resized, ColorMode mode);
+
+// Encode rows [rowBegin, rowEnd) of a resized frame into `out`
+void convertRows(const cv::Mat& resized, ColorMode mode, int rowBegin, int rowEnd,
+        std::string& out);
+
+// Encode a frame as segments.size() row bands in parallel (cv::parallel_for_).
+// Written back to back, the segments equal convertFrame()'s output.
+void convertFrameBands(const cv::Mat& resized, ColorMode mode,
+        std::vector<std::string>& segments);
+
+// Upper bound on the encoded size of a width x height frame
+size_t maxFrameBytes(ColorMode mode, int width, int height);
+
+// Append `len` characters of text (an overlay such as the status line) as
+// one run of cells styled like the frame's in `mode`: bright white in the
+// color modes, with the same reset a frame cell ends with.
+void convertText(const char* text, size_t len, ColorMode mode, std::string& out);
+
+// Upper bound on convertText()'s output for `len` characters
+size_t maxTextBytes(ColorMode mode, size_t len);
+
+/* --- Inline Definitions --- */
+
+inline char brightnessToAscii(int brightness) {
+    int index = brightness * (asciiLen - 1) / 255;
+    return asciiChars[index];
+}
+
+inline const char* rgbToAnsiColor(int r, int g, int b, int brightness) {
+    if (brightness < Color::DARK_THRESHOLD) { return Color::BLACK; }
+
+    // Check for grayscale (low color variance)
+    int maxC = std::max({r, g, b});
+    int minC = std::min({r, g, b});
+    if (maxC - minC < Color::GRAYSCALE_VARIANCE) {
+        if (brightness > Color::VERY_BRIGHT) { return Color::BRIGHT_WHITE; }
+        if (brightness > Color::BRIGHT) { return Color::WHITE; }
+        return Color::BRIGHT_BLACK;
+    }
+
+    // Classify color
+    bool bright = brightness > Color::MEDIUM_BRIGHT;
+    if (r > g && r > b) { return bright ? Color::BRIGHT_RED : Color::RED; }
+    if (g > r && g > b) { return bright ? Color::BRIGHT_GREEN : Color::GREEN; }
+    if (b > r && b > g) { return bright ? Color::BRIGHT_BLUE : Color::BLUE; }
+
+    return Color::WHITE;
+}
+
+// Decimal text for 0-255, so the per-cell loop never formats integers
+struct ByteDecimal {
+    char text[3];
+    uint8_t len;
+};
+
+inline constexpr std::array<ByteDecimal, 256> BYTE_DECIMALS = [] {
+    std::array<ByteDecimal, 256> table{};
+    for (int v = 0; v < 256; v++) {
+        ByteDecimal& d = table[v];
+        if (v >= 100) { d.text[d.len++] = static_cast<char>('0' + v / 100); }
+        if (v >= 10)  { d.text[d.len++] = static_cast<char>('0' + v / 10 % 10); }
+        d.text[d.len++] = static_cast<char>('0' + v % 10);
+    }
+    return table;
+}();
+
+inline void appendTrueColor(std::string& out, int r, int g, int b, int brightness) {
+    constexpr size_t prefixLen = sizeof("\x1b[38;2;") - 1;
+    constexpr size_t resetLen = sizeof("\x1b[0m") - 1;
+
+    out.append(Color::TRUECOLOR, prefixLen);
+    out.append(BYTE_DECIMALS[r].text, BYTE_DECIMALS[r].len);
+    out += ';';
+    out.append(BYTE_DECIMALS[g].text, BYTE_DECIMALS[g].len);
+    out += ';';
+    out.append(BYTE_DECIMALS[b].text, BYTE_DECIMALS[b].len);
+    out += 'm';
+    out += brightnessToAscii(brightness);
+    out.append(Color::RESET, resetLen);
+}
+
+inline std::string rgbToTrueColor(int r, int g, int b, int brightness) {
+    std::string result;
+    result.reserve(32);
+    appendTrueColor(result, r, g, b, brightness);
+
+    return result;
+}
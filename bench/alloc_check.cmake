@@ -0,0 +1,63 @@
+# Steady-state allocation check for the streaming pipeline. Plays CLIP with
+# PLAYER in each streaming configuration, output discarded, and fails when
+# any stage of --stats (decode, resize, encode, write) allocated on the heap
+# after its warmup frames. Needs a build with VIDEO2ASCII_ALLOC_STATS.
+#
+#   cmake -DPLAYER=<video2ascii> -DCLIP=<file.avi> -P alloc_check.cmake
+
+if(NOT PLAYER OR NOT CLIP)
+    message(FATAL_ERROR "Usage: cmake -DPLAYER=<video2ascii> -DCLIP=<file.avi> -P alloc_check.cmake")
+endif()
+
+# Each configuration reaches a different part of the pipeline
+set(CONFIGS
+    "frames: decoder, dispatcher, worker pool, frame ring|--color=full --threads=3"
+    "rows: row bands encoded in parallel, one writev|--color=ansi --parallel=rows --threads=3"
+    "loop: second pass replayed from the cell cache|--color=full --loop=2"
+    "hud: status line drawn into the gathered write|--color=ansi --hud"
+    "tee: a second sink|--color=full --tee=${CMAKE_CURRENT_BINARY_DIR}/alloc_check_tee.txt"
+)
+
+set(failures 0)
+foreach(config IN LISTS CONFIGS)
+    string(REPLACE "|" ";" parts "${config}")
+    list(GET parts 0 name)
+    list(GET parts 1 args)
+    separate_arguments(args UNIX_COMMAND "${args}")
+
+    execute_process(
+        COMMAND ${PLAYER} ${CLIP} --framerate=120 --stats ${args}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+        ERROR_VARIABLE stats)
+    if(NOT result EQUAL 0)
+        message(SEND_ERROR "${name}: player exited with ${result}\n${stats}")
+        math(EXPR failures "${failures} + 1")
+        continue()
+    endif()
+
+    # Rows of the allocation table: stage, allocs/frame, bytes/frame, steady
+    string(REGEX MATCHALL "\n(decode|resize|encode|write) +[0-9.]+ +[0-9]+ +[0-9]+" rows "${stats}")
+    list(LENGTH rows stages)
+    if(NOT stages EQUAL 4)
+        message(SEND_ERROR "${name}: no allocation table in --stats (not an ALLOC_STATS build?)\n${stats}")
+        math(EXPR failures "${failures} + 1")
+        continue()
+    endif()
+    set(clean TRUE)
+    foreach(row IN LISTS rows)
+        string(REGEX MATCH "([a-z]+) +[0-9.]+ +[0-9]+ +([0-9]+)$" _ "${row}")
+        if(NOT CMAKE_MATCH_2 EQUAL 0)
+            message(SEND_ERROR "${name}: ${CMAKE_MATCH_1} made ${CMAKE_MATCH_2} allocation(s) after warmup")
+            math(EXPR failures "${failures} + 1")
+            set(clean FALSE)
+        endif()
+    endforeach()
+    if(clean)
+        message(STATUS "${name}: no steady-state allocations")
+    endif()
+endforeach()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${failures} steady-state allocation failure(s)")
+endif()
@@ -0,0 +1,288 @@
+#include "ascii.hpp"
+#include "decode_scale.hpp"
+
+#include <benchmark/benchmark.h>
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* --- Helpers --- */
+
+namespace {
+
+constexpr std::array<std::pair<int, int>, 4> GRID_SIZES = {{
+    {40, 20}, {80, 40}, {120, 60}, {200, 120}
+}};
+
+constexpr std::array<std::pair<int, int>, 4> SOURCE_SIZES = {{
+    {640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160}
+}};
+
+// LED wall widths; heights follow a 16:9 picture in 1:2 character cells
+constexpr std::array<int, 3> WALL_WIDTHS = {400, 800, 1600};
+
+constexpr std::array<std::pair<int, int>, 2> LARGE_SOURCE_SIZES = {{
+    {3840, 2160}, {7680, 4320}
+}};
+
+// Fixed seed so every run sees identical pixel data
+cv::Mat randomImage(int width, int height, int type) {
+    cv::Mat img(height, width, type);
+    cv::RNG rng(0x5eed);
+    rng.fill(img, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+    return img;
+}
+
+void setCellCounters(benchmark::State& state, int64_t cells, int64_t bytes) {
+    state.counters["cells/s"] = benchmark::Counter(
+        static_cast<double>(cells), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(bytes);
+}
+
+void gridArgs(benchmark::internal::Benchmark* b) {
+    for (int mode = 0; mode < 3; mode++) {
+        for (const auto& [w, h] : GRID_SIZES) { b->Args({mode, w, h}); }
+    }
+    b->ArgNames({"mode", "w", "h"});
+}
+
+void resizeArgs(benchmark::internal::Benchmark* b) {
+    for (int mode = 0; mode < 2; mode++) {
+        for (const auto& [sw, sh] : SOURCE_SIZES) {
+            for (const auto& [w, h] : GRID_SIZES) { b->Args({mode, sw, sh, w, h}); }
+        }
+    }
+    b->ArgNames({"color", "srcW", "srcH", "w", "h"});
+}
+
+void largeResizeArgs(benchmark::internal::Benchmark* b) {
+    const ResizeMethod methods[] = {ResizeMethod::Area, ResizeMethod::Pyramid};
+    for (ResizeMethod method : methods) {
+        for (int color = 0; color < 2; color++) {
+            for (const auto& [sw, sh] : LARGE_SOURCE_SIZES) {
+                b->Args({static_cast<int>(method), color, sw, sh});
+            }
+        }
+    }
+    b->ArgNames({"method", "color", "srcW", "srcH"});
+}
+
+void decodeArgs(benchmark::internal::Benchmark* b) {
+    for (const auto& [sw, sh] : SOURCE_SIZES) {
+        if (sw < 1920) { continue; }
+        for (int scale : {1, 2, 4, 8}) { b->Args({sw, sh, scale}); }
+    }
+    b->ArgNames({"srcW", "srcH", "scale"});
+}
+
+}
+
+/* --- Per-Cell Kernels --- */
+
+static void BM_BrightnessToAscii(benchmark::State& state) {
+    int64_t cells = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 256; i++) {
+            benchmark::DoNotOptimize(brightnessToAscii(i));
+        }
+        cells += 256;
+    }
+    setCellCounters(state, cells, cells);
+}
+BENCHMARK(BM_BrightnessToAscii);
+
+static void BM_RgbToAnsiColor(benchmark::State& state) {
+    const cv::Mat px = randomImage(256, 1, CV_8UC3);
+    const cv::Vec3b* row = px.ptr<cv::Vec3b>(0);
+    int64_t cells = 0, bytes = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < px.cols; i++) {
+            int b = row[i][0], g = row[i][1], r = row[i][2];
+            const char* code = rgbToAnsiColor(r, g, b, (r + g + b) / 3);
+            benchmark::DoNotOptimize(code);
+            bytes += static_cast<int64_t>(std::strlen(code));
+        }
+        cells += px.cols;
+    }
+    setCellCounters(state, cells, bytes);
+}
+BENCHMARK(BM_RgbToAnsiColor);
+
+static void BM_RgbToTrueColor(benchmark::State& state) {
+    const cv::Mat px = randomImage(256, 1, CV_8UC3);
+    const cv::Vec3b* row = px.ptr<cv::Vec3b>(0);
+    int64_t cells = 0, bytes = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < px.cols; i++) {
+            int b = row[i][0], g = row[i][1], r = row[i][2];
+            std::string code = rgbToTrueColor(r, g, b, (r + g + b) / 3);
+            benchmark::DoNotOptimize(code.data());
+            bytes += static_cast<int64_t>(code.size());
+        }
+        cells += px.cols;
+    }
+    setCellCounters(state, cells, bytes);
+}
+BENCHMARK(BM_RgbToTrueColor);
+
+/* --- Frame Stages --- */
+
+// Args: color mode, grid width, grid height
+static void BM_ConvertFrame(benchmark::State& state) {
+    const auto mode = static_cast<ColorMode>(state.range(0));
+    const int width = static_cast<int>(state.range(1));
+    const int height = static_cast<int>(state.range(2));
+    const cv::Mat resized = randomImage(width, height,
+        mode == ColorMode::None ? CV_8UC1 : CV_8UC3);
+    std::string out;
+    int64_t cells = 0, bytes = 0;
+
+    for (auto _ : state) {
+        convertFrame(resized, mode, out);
+        benchmark::DoNotOptimize(out.data());
+        cells += static_cast<int64_t>(width) * height;
+        bytes += static_cast<int64_t>(out.size());
+    }
+    setCellCounters(state, cells, bytes);
+}
+BENCHMARK(BM_ConvertFrame)->Apply(gridArgs);
+
+// Args: color mode, row bands. Latency of one 200x120 frame encoded as
+// parallel row bands (--parallel=rows).
+static void BM_ConvertFrameBands(benchmark::State& state) {
+    const auto mode = static_cast<ColorMode>(state.range(0));
+    const int bands = static_cast<int>(state.range(1));
+    constexpr int width = 200, height = 120;
+    const cv::Mat resized = randomImage(width, height,
+        mode == ColorMode::None ? CV_8UC1 : CV_8UC3);
+    std::vector<std::string> segments(bands);
+    cv::setNumThreads(bands);
+    int64_t cells = 0, bytes = 0;
+
+    for (auto _ : state) {
+        convertFrameBands(resized, mode, segments);
+        benchmark::DoNotOptimize(segments.data());
+        cells += static_cast<int64_t>(width) * height;
+        for (const std::string& s : segments) { bytes += static_cast<int64_t>(s.size()); }
+    }
+    cv::setNumThreads(-1);
+    setCellCounters(state, cells, bytes);
+}
+BENCHMARK(BM_ConvertFrameBands)
+    ->ArgsProduct({{0, 1, 2}, {1, 2, 4, 8}})->ArgNames({"mode", "bands"})
+    ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// Args: color mode, grid width (WALL_WIDTHS), row bands. Encode throughput
+// at LED wall sizes, whole (1 band) and split across threads.
+static void BM_ConvertWall(benchmark::State& state) {
+    const auto mode = static_cast<ColorMode>(state.range(0));
+    const int width = static_cast<int>(state.range(1));
+    const int height = width * 9 / 32;
+    const int bands = static_cast<int>(state.range(2));
+    const cv::Mat resized = randomImage(width, height,
+        mode == ColorMode::None ? CV_8UC1 : CV_8UC3);
+    std::vector<std::string> segments(bands);
+    cv::setNumThreads(bands);
+    int64_t cells = 0, bytes = 0;
+
+    for (auto _ : state) {
+        convertFrameBands(resized, mode, segments);
+        benchmark::DoNotOptimize(segments.data());
+        cells += static_cast<int64_t>(width) * height;
+        for (const std::string& s : segments) { bytes += static_cast<int64_t>(s.size()); }
+    }
+    cv::setNumThreads(-1);
+    setCellCounters(state, cells, bytes);
+}
+BENCHMARK(BM_ConvertWall)
+    ->ArgsProduct({{0, 1, 2}, {WALL_WIDTHS.begin(), WALL_WIDTHS.end()}, {1, 4}})
+    ->ArgNames({"mode", "w", "bands"})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Args: color, grid width (WALL_WIDTHS). A 4K source resized to LED wall
+// grids, by the method --resize=auto picks.
+static void BM_ResizeWall(benchmark::State& state) {
+    const ColorMode mode = state.range(0) ? ColorMode::Full : ColorMode::None;
+    const int width = static_cast<int>(state.range(1));
+    const cv::Size size(width, width * 9 / 32);
+    const cv::Mat frame = randomImage(3840, 2160, CV_8UC3);
+    cv::Mat resized, gray, reduced;
+    int64_t cells = 0;
+
+    for (auto _ : state) {
+        resizeFrame(frame, resized, gray, reduced, mode, size, ResizeMethod::Auto);
+        benchmark::DoNotOptimize(resized.data);
+        cells += size.area();
+    }
+    setCellCounters(state, cells,
+        static_cast<int64_t>(state.iterations()) * frame.total() * frame.elemSize());
+}
+BENCHMARK(BM_ResizeWall)
+    ->ArgsProduct({{0, 1}, {WALL_WIDTHS.begin(), WALL_WIDTHS.end()}})
+    ->ArgNames({"color", "w"})->Unit(benchmark::kMillisecond);
+
+// Args: color (0 = grayscale path, 1 = BGR path), source size, grid size
+static void BM_ResizeFrame(benchmark::State& state) {
+    const ColorMode mode = state.range(0) ? ColorMode::Full : ColorMode::None;
+    const cv::Mat frame = randomImage(static_cast<int>(state.range(1)),
+        static_cast<int>(state.range(2)), CV_8UC3);
+    const cv::Size size(static_cast<int>(state.range(3)), static_cast<int>(state.range(4)));
+    cv::Mat resized, gray;
+    int64_t cells = 0;
+
+    for (auto _ : state) {
+        resizeFrame(frame, resized, gray, mode, size);
+        benchmark::DoNotOptimize(resized.data);
+        cells += size.area();
+    }
+    // Bytes are counted on the input side, which dominates the resize cost
+    setCellCounters(state, cells,
+        static_cast<int64_t>(state.iterations()) * frame.total() * frame.elemSize());
+}
+BENCHMARK(BM_ResizeFrame)->Apply(resizeArgs)->Unit(benchmark::kMicrosecond);
+
+// Args: method (ResizeMethod::Area or Pyramid), color, source size. Very
+// large sources to a 200x60 grid, where the pyramid is selected by --resize=auto.
+static void BM_ResizeLarge(benchmark::State& state) {
+    const auto method = static_cast<ResizeMethod>(state.range(0));
+    const ColorMode mode = state.range(1) ? ColorMode::Full : ColorMode::None;
+    const cv::Mat frame = randomImage(static_cast<int>(state.range(2)),
+        static_cast<int>(state.range(3)), CV_8UC3);
+    const cv::Size size(200, 60);
+    cv::Mat resized, gray, reduced;
+    int64_t cells = 0;
+
+    for (auto _ : state) {
+        resizeFrame(frame, resized, gray, reduced, mode, size, method);
+        benchmark::DoNotOptimize(resized.data);
+        cells += size.area();
+    }
+    setCellCounters(state, cells,
+        static_cast<int64_t>(state.iterations()) * frame.total() * frame.elemSize());
+}
+BENCHMARK(BM_ResizeLarge)->Apply(largeResizeArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Args: source size, decode scale (1, 2, 4, 8). JPEG decode with DCT scaling
+// (--full-decode off): frames/s shows the gain of each reduction.
+static void BM_DecodeJpegReduced(benchmark::State& state) {
+    const cv::Mat frame = randomImage(static_cast<int>(state.range(0)),
+        static_cast<int>(state.range(1)), CV_8UC3);
+    const int scale = static_cast<int>(state.range(2));
+    std::vector<uchar> jpeg;
+    cv::imencode(".jpg", frame, jpeg);
+    cv::Mat decoded;
+
+    for (auto _ : state) {
+        decoded = cv::imdecode(jpeg, reducedImreadFlags(scale));
+        benchmark::DoNotOptimize(decoded.data);
+    }
+    state.counters["frames/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * jpeg.size());
+}
+BENCHMARK(BM_DecodeJpegReduced)->Apply(decodeArgs)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,120 @@
+#include "mpmc_queue.hpp"
+#include "spsc_queue.hpp"
+
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Handoff latency and throughput of the pipeline queues, against the mutex and
+// condition variable queue they replaced.
+
+/* --- Helpers --- */
+
+namespace {
+
+constexpr size_t CAPACITY = 8;
+constexpr uint64_t STOP = ~uint64_t(0);
+
+// The queue the pipeline used before the lock-free rings, kept as a baseline
+template <typename T>
+class LockedQueue {
+public:
+    LockedQueue(size_t capacity, int) : capacity_(capacity) {}
+
+    bool push(const T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return items_.size() < capacity_; });
+        items_.push_back(value);
+        lock.unlock();
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !items_.empty(); });
+        out = items_.front();
+        items_.pop_front();
+        lock.unlock();
+        notFull_.notify_one();
+        return true;
+    }
+
+    size_t popBatch(T* out, size_t max) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this] { return !items_.empty(); });
+        size_t n = 0;
+        while (n < max && !items_.empty()) {
+            out[n++] = items_.front();
+            items_.pop_front();
+        }
+        lock.unlock();
+        notFull_.notify_all();
+        return n;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    std::mutex mutex_;
+    std::condition_variable notEmpty_, notFull_;
+};
+
+}
+
+/* --- Handoff Latency --- */
+
+// Round trip through a pair of queues to an echo thread; half of each
+// iteration is one handoff. Arg: spins before sleeping on the futex.
+template <typename Queue>
+static void BM_HandoffPingPong(benchmark::State& state) {
+    const int spins = static_cast<int>(state.range(0));
+    Queue ping(CAPACITY, spins), pong(CAPACITY, spins);
+
+    std::thread echo([&] {
+        uint64_t v = 0;
+        while (ping.pop(v) && v != STOP) { pong.push(v); }
+    });
+
+    uint64_t v = 0;
+    for (auto _ : state) {
+        ping.push(1);
+        pong.pop(v);
+        benchmark::DoNotOptimize(v);
+    }
+    ping.push(STOP);
+    echo.join();
+    state.SetLabel("time = 2 handoffs");
+}
+BENCHMARK_TEMPLATE(BM_HandoffPingPong, SpscQueue<uint64_t>)->Arg(0)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffPingPong, MpmcQueue<uint64_t>)->Arg(0)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffPingPong, LockedQueue<uint64_t>)->Arg(0)->UseRealTime();
+
+/* --- Streaming Throughput --- */
+
+// One producer streaming to one consumer that pops up to `batch` at a time
+template <typename Queue>
+static void BM_HandoffStream(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    constexpr uint64_t ITEMS = 1 << 16;
+
+    for (auto _ : state) {
+        Queue queue(CAPACITY * 8, Waiter::DEFAULT_SPINS);
+        std::thread producer([&] {
+            for (uint64_t i = 0; i < ITEMS; i++) { queue.push(i); }
+        });
+
+        uint64_t out[64];
+        uint64_t received = 0;
+        while (received < ITEMS) { received += queue.popBatch(out, batch); }
+        producer.join();
+        benchmark::DoNotOptimize(out[0]);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ITEMS));
+}
+BENCHMARK_TEMPLATE(BM_HandoffStream, SpscQueue<uint64_t>)->Arg(1)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffStream, MpmcQueue<uint64_t>)->Arg(1)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_HandoffStream, LockedQueue<uint64_t>)->Arg(1)->Arg(8)->UseRealTime();
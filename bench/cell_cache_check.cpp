@@ -0,0 +1,120 @@
+#include "cell_cache.hpp"
+
+#include <iostream>
+#include <string>
+
+// Checks for --loop's cell cache: when the first pass is kept as cells
+// rather than streamed again (loopStreamReason), and when a kept pass may be
+// replayed (CellCache::store spoiling it, CellCache::complete). Exits
+// non-zero on any failure.
+
+/* --- Custom Types --- */
+
+struct Checker {
+    int failures = 0;
+
+    void expect(bool ok, const char* what) {
+        if (!ok) {
+            std::cerr << "FAILED " << what << '\n';
+            failures++;
+        }
+    }
+};
+
+/* --- Function Prototypes --- */
+
+void checkStreamReason(Checker& check);
+void checkComplete(Checker& check);
+void checkSpoiling(Checker& check);
+
+/* --- Main --- */
+
+int main() {
+    Checker check;
+    checkStreamReason(check);
+    checkComplete(check);
+    checkSpoiling(check);
+
+    std::cout << check.failures << " failure(s)\n";
+    return check.failures > 0 ? 1 : 0;
+}
+
+/* --- Function Definitions --- */
+
+void checkStreamReason(Checker& check) {
+    const cv::Size grid(160, 60);
+
+    check.expect(loopStreamReason(300, grid, ColorMode::Full, false, false).empty(),
+        "a clip that fits is replayed");
+    check.expect(loopStreamReason(300, grid, ColorMode::Full, true, false) == "a playlist",
+        "a playlist streams");
+    check.expect(loopStreamReason(300, grid, ColorMode::Full, false, true) == "--interactive",
+        "--interactive streams");
+    check.expect(loopStreamReason(0, grid, ColorMode::Full, false, false) == "frame count unknown",
+        "an unknown frame count streams");
+
+    // The budget is exact: the largest clip that fits, then one frame more
+    const size_t frameBytes = CellCache::bytesFor(1, grid, ColorMode::Full);
+    const size_t fits = LOOP_CACHE_BYTES / frameBytes;
+    check.expect(loopStreamReason(fits, grid, ColorMode::Full, false, false).empty(),
+        "a clip at the budget is replayed");
+    check.expect(loopStreamReason(fits + 1, grid, ColorMode::Full, false, false)
+        .rfind("cells would take", 0) == 0, "a clip over the budget streams");
+
+    // Grayscale cells are a third of the size, so three times the frames fit
+    check.expect(loopStreamReason(fits * 3, grid, ColorMode::None, false, false).empty(),
+        "grayscale cells take one byte");
+}
+
+void checkComplete(Checker& check) {
+    const cv::Size grid(40, 20);
+    const cv::Mat cells(grid, CV_8UC3, cv::Scalar(10, 20, 30));
+
+    CellCache cache(4, grid, ColorMode::Full);
+    check.expect(!cache.complete(4, 0), "an empty cache is not complete");
+    for (size_t i = 0; i < 3; i++) { cache.store(i, cells, 0); }
+    check.expect(!cache.complete(4, 0), "a missing frame leaves the cache incomplete");
+    check.expect(cache.complete(3, 0), "a shorter pass that was kept is complete");
+
+    // An unreadable frame is kept as blank
+    cache.store(3, cv::Mat(), 0);
+    check.expect(cache.complete(4, 0), "blank frames count as kept");
+    check.expect(cache.blank(3) && !cache.blank(0), "only the unreadable frame is blank");
+    const uchar* kept = cache.cells(2).ptr<uchar>(5) + 5 * 3;
+    check.expect(kept[0] == 10 && kept[1] == 20 && kept[2] == 30,
+        "cells are copied into the cache");
+
+    check.expect(!cache.complete(0, 0), "a pass without frames is not complete");
+    check.expect(!cache.complete(5, 0), "a longer pass than the room is not complete");
+    check.expect(!cache.complete(4, 1), "cells of another grid generation do not replay");
+
+    // A frame converted after a resize leaves a mix of generations
+    CellCache mixed(2, grid, ColorMode::Full);
+    mixed.store(0, cells, 0);
+    mixed.store(1, cells, 1);
+    check.expect(!mixed.complete(2, 0) && !mixed.complete(2, 1),
+        "a pass across a resize is not complete");
+}
+
+void checkSpoiling(Checker& check) {
+    const cv::Size grid(40, 20);
+
+    CellCache beyond(2, grid, ColorMode::Full);
+    beyond.store(0, cv::Mat(grid, CV_8UC3), 0);
+    beyond.store(1, cv::Mat(grid, CV_8UC3), 0);
+    beyond.store(2, cv::Mat(grid, CV_8UC3), 0);
+    check.expect(!beyond.complete(2, 0), "a frame beyond the room spoils the cache");
+
+    CellCache resized(2, grid, ColorMode::Full);
+    resized.store(0, cv::Mat(grid, CV_8UC3), 0);
+    resized.store(1, cv::Mat(cv::Size(30, 15), CV_8UC3), 0);
+    check.expect(!resized.complete(2, 0), "cells of another size spoil the cache");
+
+    // Spoiling is for good: storing the frame again does not undo it
+    resized.store(1, cv::Mat(grid, CV_8UC3), 0);
+    check.expect(!resized.complete(2, 0), "a spoiled cache stays spoiled");
+
+    CellCache gray(1, grid, ColorMode::None);
+    gray.store(0, cv::Mat(grid, CV_8UC3), 0);
+    check.expect(!gray.complete(1, 0), "cells of another type spoil the cache");
+}
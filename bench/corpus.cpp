@@ -0,0 +1,143 @@
+#include "corpus.hpp"
+
+#include <cmath>
+
+/* --- Helpers --- */
+
+namespace {
+
+constexpr uint64_t CORPUS_SEED = 0x76326173636969ULL;
+
+// Stable per-(frame, salt) RNG so frames can be rendered in any order
+cv::RNG frameRng(int index, int salt) {
+    return cv::RNG(CORPUS_SEED ^ (static_cast<uint64_t>(index) << 16) ^ static_cast<uint64_t>(salt));
+}
+
+cv::Scalar randomColor(cv::RNG& rng) {
+    return cv::Scalar(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+}
+
+void renderGradient(cv::Mat& frame, int offset) {
+    const int period = std::max(frame.cols, 1);
+    for (int y = 0; y < frame.rows; y++) {
+        cv::Vec3b* row = frame.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < frame.cols; x++) {
+            int t = ((x + offset) % period) * 255 / period;
+            int u = y * 255 / std::max(frame.rows - 1, 1);
+            row[x][0] = static_cast<uchar>(t);
+            row[x][1] = static_cast<uchar>(u);
+            row[x][2] = static_cast<uchar>(255 - (t + u) / 2);
+        }
+    }
+}
+
+void renderShapes(cv::Mat& frame, cv::RNG& rng, int count) {
+    for (int i = 0; i < count; i++) {
+        cv::Point a(rng.uniform(0, frame.cols), rng.uniform(0, frame.rows));
+        cv::Point b(rng.uniform(0, frame.cols), rng.uniform(0, frame.rows));
+        cv::rectangle(frame, a, b, randomColor(rng), cv::FILLED);
+    }
+}
+
+// Triangle wave in [0, range) so objects bounce off the frame edges
+int bounce(long long t, int range) {
+    if (range <= 0) { return 0; }
+    long long p = t % (2LL * range);
+    return static_cast<int>(p < range ? p : 2LL * range - p - 1);
+}
+
+}
+
+/* --- Function Definitions --- */
+
+const char* patternName(Pattern pattern) {
+    switch (pattern) {
+        case Pattern::Static:      return "static";
+        case Pattern::Noise:       return "noise";
+        case Pattern::GradientPan: return "gradient";
+        case Pattern::SceneCuts:   return "cuts";
+        case Pattern::TextScroll:  return "text";
+        case Pattern::HighMotion:  return "motion";
+    }
+    return "unknown";
+}
+
+bool parsePattern(const std::string& name, Pattern& pattern) {
+    for (Pattern p : ALL_PATTERNS) {
+        if (name == patternName(p)) {
+            pattern = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+void renderPattern(Pattern pattern, int index, double fps, cv::Mat& frame) {
+    const int w = frame.cols, h = frame.rows;
+    const int framesPerScene = std::max(1, static_cast<int>(fps / 2));
+
+    switch (pattern) {
+        case Pattern::Static: {
+            renderGradient(frame, 0);
+            cv::RNG rng = frameRng(0, 1);
+            renderShapes(frame, rng, 8);
+            break;
+        }
+        case Pattern::Noise: {
+            cv::RNG rng = frameRng(index, 2);
+            rng.fill(frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+            break;
+        }
+        case Pattern::GradientPan:
+            renderGradient(frame, index * std::max(1, w / 120));
+            break;
+        case Pattern::SceneCuts: {
+            cv::RNG rng = frameRng(index / framesPerScene, 3);
+            frame.setTo(randomColor(rng));
+            renderShapes(frame, rng, 12);
+            break;
+        }
+        case Pattern::TextScroll: {
+            frame.setTo(cv::Scalar(16, 16, 16));
+            const double scale = h / 540.0;
+            const int lineHeight = std::max(1, static_cast<int>(40 * scale));
+            const int scroll = index * std::max(1, lineHeight / 8);
+            const int firstLine = scroll / lineHeight;
+            for (int line = firstLine; line * lineHeight - scroll < h + lineHeight; line++) {
+                int y = line * lineHeight - scroll;
+                cv::putText(frame, "Line " + std::to_string(line) + ": the quick brown fox jumps over the lazy dog",
+                    cv::Point(lineHeight / 2, y), cv::FONT_HERSHEY_SIMPLEX, scale,
+                    cv::Scalar(230, 230, 230), std::max(1, static_cast<int>(2 * scale)), cv::LINE_AA);
+            }
+            break;
+        }
+        case Pattern::HighMotion: {
+            renderGradient(frame, index * std::max(1, w / 30));
+            cv::RNG rng = frameRng(0, 4);
+            const int radius = std::max(2, h / 20);
+            for (int i = 0; i < 24; i++) {
+                int vx = rng.uniform(w / 60 + 1, w / 15 + 2);
+                int vy = rng.uniform(h / 60 + 1, h / 15 + 2);
+                int x0 = rng.uniform(0, w), y0 = rng.uniform(0, h);
+                cv::Scalar color = randomColor(rng);
+                cv::Point c(bounce(x0 + static_cast<long long>(index) * vx, w),
+                            bounce(y0 + static_cast<long long>(index) * vy, h));
+                cv::circle(frame, c, radius, color, cv::FILLED, cv::LINE_AA);
+            }
+            break;
+        }
+    }
+}
+
+bool writeCorpusVideo(const std::string& path, Pattern pattern, cv::Size size,
+        double fps, int frameCount) {
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps, size);
+    if (!writer.isOpened()) { return false; }
+
+    cv::Mat frame(size, CV_8UC3);
+    for (int i = 0; i < frameCount; i++) {
+        renderPattern(pattern, i, fps, frame);
+        writer.write(frame);
+    }
+    return true;
+}
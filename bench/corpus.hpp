@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+#include <string>
+
+// Deterministic synthetic video content for benchmarks. Every frame is a pure
+// function of (pattern, frame index, frame size), so the rendered frames are
+// identical on any host. Encoded files are not: MJPG output, and so the
+// decoded pixels, depend on the JPEG encoder in the OpenCV build.
+
+enum class Pattern : uint8_t {
+    Static,         // One still image held for the whole clip
+    Noise,          // Independent uniform noise per frame (worst case for deltas)
+    GradientPan,    // Diagonal color gradient panning horizontally
+    SceneCuts,      // Flat scenes with shapes, hard cut twice per second
+    TextScroll,     // Lines of text scrolling upwards on a dark background
+    HighMotion      // Many fast bouncing shapes over a moving background
+};
+
+constexpr Pattern ALL_PATTERNS[] = {
+    Pattern::Static, Pattern::Noise, Pattern::GradientPan,
+    Pattern::SceneCuts, Pattern::TextScroll, Pattern::HighMotion
+};
+
+const char* patternName(Pattern pattern);
+bool parsePattern(const std::string& name, Pattern& pattern);
+
+// Render frame `index` of `pattern` into `frame`, which must already be an
+// allocated CV_8UC3 image of the desired size.
+void renderPattern(Pattern pattern, int index, double fps, cv::Mat& frame);
+
+// Encode `frameCount` frames of `pattern` to `path` (MJPG in AVI, which every
+// OpenCV build can write). Returns false if the writer could not be opened.
+bool writeCorpusVideo(const std::string& path, Pattern pattern, cv::Size size,
+        double fps, int frameCount);
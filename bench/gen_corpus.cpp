@@ -0,0 +1,107 @@
+#include "corpus.hpp"
+
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* --- Custom Types --- */
+
+struct CorpusOptions {
+    std::string outDir          = ".";
+    std::vector<Pattern> patterns;
+    int width                   = 1280;
+    int height                  = 720;
+    double fps                  = 30;
+    double seconds              = 5;
+};
+
+/* --- Function Prototypes --- */
+
+int getCorpusOptions(CorpusOptions& opts, int argc, char** argv);
+void printCorpusHelp();
+
+/* --- Main --- */
+
+int main(int argc, char** argv) {
+    CorpusOptions opts;
+    if (getCorpusOptions(opts, argc, argv) == 1) {
+        return 1;
+    }
+    if (opts.patterns.empty()) {
+        opts.patterns.assign(std::begin(ALL_PATTERNS), std::end(ALL_PATTERNS));
+    }
+
+    const cv::Size size(opts.width, opts.height);
+    const int frameCount = std::max(1, static_cast<int>(opts.seconds * opts.fps + 0.5));
+
+    for (Pattern pattern : opts.patterns) {
+        std::string path = opts.outDir + "/" + patternName(pattern) + "_"
+            + std::to_string(opts.width) + "x" + std::to_string(opts.height) + ".avi";
+        if (!writeCorpusVideo(path, pattern, size, opts.fps, frameCount)) {
+            std::cerr << "Error: Could not write " << path << '\n';
+            return 1;
+        }
+        std::cout << path << '\n';
+    }
+
+    return 0;
+}
+
+/* --- Function Definitions --- */
+
+int getCorpusOptions(CorpusOptions& opts, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        try {
+            if (strncmp(argv[i], "--out=", 6) == 0) {
+                opts.outDir = argv[i] + 6;
+            } else if (strncmp(argv[i], "--pattern=", 10) == 0) {
+                Pattern pattern;
+                if (!parsePattern(argv[i] + 10, pattern)) {
+                    std::cerr << "Unknown pattern: " << argv[i] + 10 << '\n';
+                    return 1;
+                }
+                opts.patterns.push_back(pattern);
+            } else if (strncmp(argv[i], "--size=", 7) == 0) {
+                std::string size = argv[i] + 7;
+                size_t x = size.find('x');
+                if (x == std::string::npos) { throw std::invalid_argument(size); }
+                opts.width = std::stoi(size.substr(0, x));
+                opts.height = std::stoi(size.substr(x + 1));
+            } else if (strncmp(argv[i], "--fps=", 6) == 0) {
+                opts.fps = std::stod(argv[i] + 6);
+            } else if (strncmp(argv[i], "--seconds=", 10) == 0) {
+                opts.seconds = std::stod(argv[i] + 10);
+            } else if (strcmp(argv[i], "--help") == 0) {
+                printCorpusHelp();
+                return 1;
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << "\n";
+                std::cerr << "Use --help for usage information\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid value for " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (opts.width < 16 || opts.height < 16 || opts.fps <= 0 || opts.seconds <= 0) {
+        std::cerr << "Error: Corpus dimensions, fps and duration must be positive\n";
+        return 1;
+    }
+    return 0;
+}
+
+void printCorpusHelp() {
+    std::cerr << "Usage: video2ascii_corpus_gen [options]\n\n"
+              << "Options:\n"
+              << "  --out=<dir>       Output directory (default: .)\n"
+              << "  --pattern=<name>  static, noise, gradient, cuts, text, motion\n"
+              << "                    (repeatable, default: all)\n"
+              << "  --size=<w>x<h>    Frame size (default: 1280x720)\n"
+              << "  --fps=<n>         Frames per second (default: 30)\n"
+              << "  --seconds=<n>     Clip duration (default: 5)\n"
+              << "  --help            Show this help message\n";
+}
@@ -0,0 +1,331 @@
+#include "ascii.hpp"
+#include "corpus.hpp"
+#include "reference.hpp"
+#include "vt_screen.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Golden-output verification for the conversion kernels. The synthetic
+// corpus is resized by resizeFrame() and by the frozen reference, and every
+// encoder path encodes the cells next to the reference encoder. Both outputs
+// are parsed back into cell grids. Glyph grids must hash identically for
+// every path; only colors may differ, by at most --tolerance per channel
+// (resizeFrame may round differently from the reference resize).
+//
+// The box pyramid (--resize=pyramid) approximates INTER_AREA by design, so
+// its cells cannot match the reference's. Its encode is held to the same
+// exact glyph hash against the reference encoder of the same cells, and the
+// cells themselves must stay close to the reference's: their brightness may
+// differ by PYRAMID_MEAN_DELTA levels on average, far below the 28 levels one
+// glyph covers. Single cells at hard edges may differ by more; that is the
+// approximation.
+// Exits non-zero on any mismatch.
+
+/* --- Custom Types --- */
+
+// An encoder path: cells (as produced by resizeFrame) to terminal text
+struct KernelPath {
+    const char* name;
+    std::string (*encode)(const cv::Mat& cells, ColorMode mode);
+};
+
+// Pyramid cells: mean brightness difference allowed from the reference's
+constexpr double PYRAMID_MEAN_DELTA = 3.0;
+
+struct GoldenOptions {
+    cv::Size source         = cv::Size(1280, 720);
+    std::vector<cv::Size> grids = {cv::Size(40, 20), cv::Size(120, 60), cv::Size(200, 120)};
+    int frames              = 30;
+    int tolerance           = 2;
+    std::string recordPath;
+    std::string checkPath;
+};
+
+struct GridHash {
+    uint64_t glyphs;
+    uint64_t colors;
+};
+
+/* --- Kernel Paths --- */
+
+static std::string frameEncode(const cv::Mat& cells, ColorMode mode) {
+    return convertFrame(cells, mode);
+}
+
+// convertFrame into a buffer kept across frames, as the player does
+static std::string reusedBufferEncode(const cv::Mat& cells, ColorMode mode) {
+    static std::string out;
+    convertFrame(cells, mode, out);
+    return out;
+}
+
+// convertRows over uneven chunks, to catch off-by-one row ranges
+static std::string rowsEncode(const cv::Mat& cells, ColorMode mode) {
+    const int bounds[] = {0, cells.rows / 3, cells.rows / 3 + 1, cells.rows * 5 / 7, cells.rows};
+    std::string out, chunk;
+    for (size_t i = 0; i + 1 < std::size(bounds); i++) {
+        convertRows(cells, mode, bounds[i], bounds[i + 1], chunk);
+        out += chunk;
+    }
+    return out;
+}
+
+// One band: RowBandEncoder run directly on the calling thread
+static std::string bandEncoderEncode(const cv::Mat& cells, ColorMode mode) {
+    static std::vector<std::string> segments(1);
+    convertFrameBands(cells, mode, segments);
+    return segments[0];
+}
+
+// Row bands in parallel, as --parallel=rows does; an odd band count leaves
+// uneven bands
+static std::string parallelBandsEncode(const cv::Mat& cells, ColorMode mode) {
+    static std::vector<std::string> segments(3);
+    convertFrameBands(cells, mode, segments);
+    std::string out;
+    for (const std::string& segment : segments) { out += segment; }
+    return out;
+}
+
+static const KernelPath PATHS[] = {
+    {"convert-frame", frameEncode},
+    {"reused-buffer", reusedBufferEncode},
+    {"convert-rows", rowsEncode},
+    {"band-encoder", bandEncoderEncode},
+    {"parallel-bands", parallelBandsEncode},
+};
+
+/* --- Function Prototypes --- */
+
+int getGoldenOptions(GoldenOptions& opts, int argc, char** argv);
+bool parseSize(const char* str, cv::Size& size);
+GridHash hashScreen(const VtScreen& screen);
+int maxColorDelta(uint32_t a, uint32_t b);
+int worstColorDelta(const VtScreen& expected, const VtScreen& actual);
+bool pyramidCellsClose(const cv::Mat& reference, const cv::Mat& pyramid);
+
+/* --- Main --- */
+
+int main(int argc, char** argv) {
+    GoldenOptions opts;
+    if (getGoldenOptions(opts, argc, argv) == 1) {
+        return 1;
+    }
+
+    constexpr ColorMode modes[] = {ColorMode::None, ColorMode::ANSI, ColorMode::Full};
+    constexpr const char* modeNames[] = {"none", "ansi", "full"};
+
+    std::ifstream check;
+    std::ofstream record;
+    if (!opts.checkPath.empty()) {
+        check.open(opts.checkPath);
+        if (!check) {
+            std::cerr << "Error: Could not open " << opts.checkPath << '\n';
+            return 1;
+        }
+    }
+    if (!opts.recordPath.empty()) {
+        record.open(opts.recordPath);
+        if (!record) {
+            std::cerr << "Error: Could not write " << opts.recordPath << '\n';
+            return 1;
+        }
+    }
+
+    cv::Mat frame(opts.source, CV_8UC3), cells, gray, reduced, pyramidCells;
+    long long compared = 0, failures = 0;
+
+    for (Pattern pattern : ALL_PATTERNS) {
+        for (size_t m = 0; m < std::size(modes); m++) {
+            for (const cv::Size& grid : opts.grids) {
+                // One spare row absorbs the newline after the last line
+                VtScreen expected(grid.width, grid.height + 1);
+                VtScreen actual(grid.width, grid.height + 1);
+
+                for (int i = 0; i < opts.frames; i++) {
+                    renderPattern(pattern, i, 30, frame);
+                    const cv::Mat refCells = referenceResize(frame, modes[m], grid);
+                    const std::string ref = referenceEncode(refCells, modes[m]);
+                    expected.reset();
+                    expected.feed(ref.data(), ref.size());
+                    const GridHash refHash = hashScreen(expected);
+
+                    char key[128];
+                    std::snprintf(key, sizeof(key), "%s %s %dx%d %d", patternName(pattern),
+                                  modeNames[m], grid.width, grid.height, i);
+                    if (record.is_open()) {
+                        record << key << ' ' << std::hex << refHash.glyphs << ' '
+                               << refHash.colors << std::dec << '\n';
+                    }
+                    if (check.is_open()) {
+                        std::string line, want = key;
+                        std::getline(check, line);
+                        char got[64];
+                        std::snprintf(got, sizeof(got), " %llx %llx",
+                                      static_cast<unsigned long long>(refHash.glyphs),
+                                      static_cast<unsigned long long>(refHash.colors));
+                        if (line != want + got) {
+                            std::cerr << "GOLDEN MISMATCH reference " << key << '\n';
+                            failures++;
+                        }
+                    }
+
+                    resizeFrame(frame, cells, gray, modes[m], grid);
+                    for (const KernelPath& path : PATHS) {
+                        const std::string out = path.encode(cells, modes[m]);
+                        actual.reset();
+                        actual.feed(out.data(), out.size());
+                        const GridHash outHash = hashScreen(actual);
+                        compared++;
+
+                        if (outHash.glyphs != refHash.glyphs) {
+                            std::cerr << "GLYPH MISMATCH " << path.name << ' ' << key << '\n';
+                            failures++;
+                            continue;
+                        }
+                        if (outHash.colors == refHash.colors) { continue; }
+                        const int worst = worstColorDelta(expected, actual);
+                        if (worst > opts.tolerance) {
+                            std::cerr << "COLOR MISMATCH " << path.name << ' ' << key
+                                      << " (max channel delta " << worst << ")\n";
+                            failures++;
+                        }
+                    }
+
+                    // The pyramid's own cells, encoded by both encoders
+                    resizeFrame(frame, pyramidCells, gray, reduced, modes[m], grid,
+                        ResizeMethod::Pyramid);
+                    const std::string pyramidRef = referenceEncode(pyramidCells, modes[m]);
+                    const std::string pyramidOut = convertFrame(pyramidCells, modes[m]);
+                    expected.reset();
+                    expected.feed(pyramidRef.data(), pyramidRef.size());
+                    actual.reset();
+                    actual.feed(pyramidOut.data(), pyramidOut.size());
+                    compared++;
+                    if (hashScreen(actual).glyphs != hashScreen(expected).glyphs ||
+                            worstColorDelta(expected, actual) > 0) {
+                        std::cerr << "ENCODE MISMATCH pyramid " << key << '\n';
+                        failures++;
+                    } else if (!pyramidCellsClose(refCells, pyramidCells)) {
+                        std::cerr << "PYRAMID CELLS DIVERGE " << key << '\n';
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << compared << " frames compared across " << std::size(PATHS) + 1
+              << " kernel path(s), " << failures << " mismatch(es)\n";
+    return failures == 0 ? 0 : 1;
+}
+
+/* --- Function Definitions --- */
+
+int getGoldenOptions(GoldenOptions& opts, int argc, char** argv) {
+    bool gridsGiven = false;
+    for (int i = 1; i < argc; i++) {
+        try {
+            if (strncmp(argv[i], "--size=", 7) == 0) {
+                if (!parseSize(argv[i] + 7, opts.source)) { throw std::invalid_argument(argv[i]); }
+            } else if (strncmp(argv[i], "--grid=", 7) == 0) {
+                cv::Size grid;
+                if (!parseSize(argv[i] + 7, grid)) { throw std::invalid_argument(argv[i]); }
+                if (!gridsGiven) { opts.grids.clear(); }
+                gridsGiven = true;
+                opts.grids.push_back(grid);
+            } else if (strncmp(argv[i], "--frames=", 9) == 0) {
+                opts.frames = std::stoi(argv[i] + 9);
+            } else if (strncmp(argv[i], "--tolerance=", 12) == 0) {
+                opts.tolerance = std::stoi(argv[i] + 12);
+            } else if (strncmp(argv[i], "--record=", 9) == 0) {
+                opts.recordPath = argv[i] + 9;
+            } else if (strncmp(argv[i], "--check=", 8) == 0) {
+                opts.checkPath = argv[i] + 8;
+            } else {
+                std::cerr << "Usage: video2ascii_golden [--size=<w>x<h>] [--grid=<w>x<h>]... "
+                          << "[--frames=<n>] [--tolerance=<n>] [--record=<file>] [--check=<file>]\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid value for " << argv[i] << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
+
+bool parseSize(const char* str, cv::Size& size) {
+    int w = 0, h = 0;
+    if (std::sscanf(str, "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) { return false; }
+    size = cv::Size(w, h);
+    return true;
+}
+
+// FNV-1a over the glyph grid and, separately, the foreground color grid
+GridHash hashScreen(const VtScreen& screen) {
+    constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+    GridHash hash{FNV_OFFSET, FNV_OFFSET};
+
+    for (int y = 0; y < screen.rows(); y++) {
+        for (int x = 0; x < screen.cols(); x++) {
+            const VtCell& cell = screen.at(x, y);
+            hash.glyphs = (hash.glyphs ^ static_cast<uchar>(cell.ch)) * FNV_PRIME;
+            for (int shift = 0; shift < 32; shift += 8) {
+                hash.colors = (hash.colors ^ ((cell.fg >> shift) & 0xFF)) * FNV_PRIME;
+            }
+        }
+    }
+    return hash;
+}
+
+int maxColorDelta(uint32_t a, uint32_t b) {
+    if (a == b) { return 0; }
+    if (a == VtCell::DEFAULT_FG || b == VtCell::DEFAULT_FG) { return 255; }
+    int worst = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        int ca = static_cast<int>((a >> shift) & 0xFF);
+        int cb = static_cast<int>((b >> shift) & 0xFF);
+        worst = std::max(worst, std::abs(ca - cb));
+    }
+    return worst;
+}
+
+int worstColorDelta(const VtScreen& expected, const VtScreen& actual) {
+    int worst = 0;
+    for (int y = 0; y < expected.rows(); y++) {
+        for (int x = 0; x < expected.cols(); x++) {
+            worst = std::max(worst, maxColorDelta(expected.at(x, y).fg, actual.at(x, y).fg));
+        }
+    }
+    return worst;
+}
+
+bool pyramidCellsClose(const cv::Mat& reference, const cv::Mat& pyramid) {
+    if (reference.size() != pyramid.size() || reference.type() != pyramid.type()) { return false; }
+
+    // Brightness as the encoders compute it: the channel mean
+    const int channels = reference.channels();
+    double sum = 0;
+    for (int y = 0; y < reference.rows; y++) {
+        const uchar* want = reference.ptr<uchar>(y);
+        const uchar* got = pyramid.ptr<uchar>(y);
+        for (int x = 0; x < reference.cols; x++) {
+            int a = 0, b = 0;
+            for (int c = 0; c < channels; c++) {
+                a += want[x * channels + c];
+                b += got[x * channels + c];
+            }
+            sum += std::abs(a / channels - b / channels);
+        }
+    }
+    return sum <= PYRAMID_MEAN_DELTA * static_cast<double>(reference.total());
+}
@@ -0,0 +1,488 @@
+#include "ascii.hpp"
+#include "corpus.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Performance regression gate. Measures kernel throughput, end-to-end
+// headless conversion and time to first frame on the synthetic corpus,
+// compares each metric against the baseline recorded for this host and
+// exits non-zero when a metric regresses by more than its tolerance, or when
+// a baseline metric is no longer measured. The numbers are absolute, so the
+// baseline file keeps one set per host key (the host name unless --host is
+// given); a host without one skips the gate until --update records it.
+// A regression must reproduce: the run is repeated once and each metric
+// keeps its better value, so a noisy host does not fail the gate. Metrics
+// missing from the baseline are reported as new.
+
+/* --- Custom Types --- */
+
+using Clock = std::chrono::steady_clock;
+
+// CTest's SKIP_RETURN_CODE for perf_gate: no baseline for this host yet
+constexpr int EXIT_SKIPPED = 77;
+
+struct Metric {
+    double value            = 0;
+    bool higherIsBetter     = true;
+};
+
+using Metrics = std::map<std::string, Metric>;
+
+struct Baseline {
+    double tolerance = 0.15;                    // Relative, for every metric...
+    std::map<std::string, double> tolerances;   // ...except those listed here
+    std::map<std::string, Metrics> hosts;       // Recorded metrics per host key
+};
+
+struct GateOptions {
+    std::string baselinePath;
+    std::string host;               // Baseline key; the host name when empty
+    double tolerance    = -1;       // Overrides the baseline default when >= 0
+    double minSeconds   = 0.3;
+    bool update         = false;
+};
+
+/* --- Function Prototypes --- */
+
+int getGateOptions(GateOptions& opts, int argc, char** argv);
+bool readBaseline(const std::string& path, Baseline& baseline);
+bool writeBaseline(const std::string& path, const Baseline& baseline);
+std::string hostName();
+double measureRate(const std::function<double()>& run, double minSeconds);
+void measureKernels(Metrics& out, double minSeconds);
+bool measureEndToEnd(Metrics& out, double minSeconds);
+bool measureAll(Metrics& out, double minSeconds);
+double toleranceFor(const Baseline& baseline, const std::string& name);
+bool regressed(const Metric& current, const Metric& base, double tolerance);
+
+/* --- Main --- */
+
+int main(int argc, char** argv) {
+    GateOptions opts;
+    if (getGateOptions(opts, argc, argv) == 1) {
+        return 1;
+    }
+
+    Baseline baseline;
+    if (!opts.update && !readBaseline(opts.baselinePath, baseline)) {
+        std::cerr << "Error: Could not read baseline " << opts.baselinePath << '\n';
+        return 1;
+    }
+    if (opts.update) { readBaseline(opts.baselinePath, baseline); }
+
+    const std::string host = opts.host.empty() ? hostName() : opts.host;
+    if (host.empty()) {
+        std::cerr << "Error: Could not get the host name; give a baseline key with --host\n";
+        return 1;
+    }
+    auto recorded = baseline.hosts.find(host);
+    if (!opts.update && recorded == baseline.hosts.end()) {
+        std::cerr << "No baseline for host '" << host << "' in " << opts.baselinePath
+                  << "; record one with --update\n";
+        return EXIT_SKIPPED;
+    }
+
+    Metrics current;
+    if (!measureAll(current, opts.minSeconds)) {
+        std::cerr << "Error: Could not generate the end-to-end corpus clip\n";
+        return 1;
+    }
+
+    if (opts.update) {
+        // Metrics that are no longer measured are dropped; other hosts and
+        // the tolerances are kept
+        baseline.hosts[host] = current;
+        if (!writeBaseline(opts.baselinePath, baseline)) {
+            std::cerr << "Error: Could not write " << opts.baselinePath << '\n';
+            return 1;
+        }
+        std::cout << "Updated " << current.size() << " metrics for host '" << host << "' in "
+                  << opts.baselinePath << '\n';
+        return 0;
+    }
+
+    if (opts.tolerance >= 0) {
+        baseline.tolerance = opts.tolerance;
+        baseline.tolerances.clear();
+    }
+    const Metrics& base = recorded->second;
+
+    // Measure again when anything regressed, keeping each metric's better value
+    for (const auto& [name, metric] : current) {
+        auto it = base.find(name);
+        if (it == base.end() || !regressed(metric, it->second, toleranceFor(baseline, name))) {
+            continue;
+        }
+        Metrics retry;
+        if (!measureAll(retry, opts.minSeconds)) {
+            std::cerr << "Error: Could not generate the end-to-end corpus clip\n";
+            return 1;
+        }
+        for (auto& [retryName, value] : current) {
+            auto again = retry.find(retryName);
+            if (again == retry.end()) { continue; }
+            value.value = value.higherIsBetter ? std::max(value.value, again->second.value)
+                                               : std::min(value.value, again->second.value);
+        }
+        break;
+    }
+
+    int regressions = 0;
+    std::printf("Baseline of host '%s'\n", host.c_str());
+    std::printf("%-44s %14s %14s %8s\n", "metric", "baseline", "current", "change");
+    for (const auto& [name, metric] : current) {
+        auto it = base.find(name);
+        if (it == base.end()) {
+            std::printf("%-44s %14s %14.4g %8s\n", name.c_str(), "-", metric.value, "new");
+            continue;
+        }
+
+        const Metric& recordedMetric = it->second;
+        const double change = recordedMetric.value != 0
+            ? (metric.value - recordedMetric.value) / recordedMetric.value
+            : (metric.value == 0 ? 0.0 : INFINITY);
+        const bool worse = regressed(metric, recordedMetric, toleranceFor(baseline, name));
+
+        std::printf("%-44s %14.4g %14.4g %+7.1f%%%s\n", name.c_str(), recordedMetric.value,
+                    metric.value, change * 100, worse ? "  REGRESSED" : "");
+        if (worse) { regressions++; }
+    }
+
+    // A baseline metric the run did not produce would otherwise never be gated
+    int missing = 0;
+    for (const auto& [name, metric] : base) {
+        if (current.count(name) == 0) {
+            std::printf("%-44s %14.4g %14s %8s\n", name.c_str(), metric.value, "-", "MISSING");
+            missing++;
+        }
+    }
+
+    if (regressions > 0) {
+        std::cerr << regressions << " metric(s) regressed beyond tolerance\n";
+    }
+    if (missing > 0) {
+        std::cerr << missing << " baseline metric(s) not measured\n";
+    }
+    return regressions > 0 || missing > 0 ? 1 : 0;
+}
+
+/* --- Measurement --- */
+
+bool measureAll(Metrics& out, double minSeconds) {
+    measureKernels(out, minSeconds);
+    return measureEndToEnd(out, minSeconds);
+}
+
+double toleranceFor(const Baseline& baseline, const std::string& name) {
+    auto it = baseline.tolerances.find(name);
+    return it != baseline.tolerances.end() ? it->second : baseline.tolerance;
+}
+
+bool regressed(const Metric& current, const Metric& base, double tolerance) {
+    return base.higherIsBetter ? current.value < base.value * (1.0 - tolerance)
+                               : current.value > base.value * (1.0 + tolerance);
+}
+
+// Run `run` (which returns the amount of work it did) until `minSeconds` have
+// elapsed, three times, and return the best observed work per second
+double measureRate(const std::function<double()>& run, double minSeconds) {
+    double best = 0;
+    for (int rep = 0; rep < 3; rep++) {
+        double work = 0;
+        const auto start = Clock::now();
+        double elapsed = 0;
+        do {
+            work += run();
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+        best = std::max(best, work / elapsed);
+    }
+    return best;
+}
+
+void measureKernels(Metrics& out, double minSeconds) {
+    constexpr ColorMode modes[] = {ColorMode::None, ColorMode::ANSI, ColorMode::Full};
+    constexpr const char* modeNames[] = {"none", "ansi", "full"};
+    const cv::Size grids[] = {cv::Size(80, 40), cv::Size(200, 120)};
+    const cv::Size sources[] = {cv::Size(1920, 1080), cv::Size(3840, 2160)};
+
+    cv::Mat source;
+    for (size_t m = 0; m < std::size(modes); m++) {
+        for (const cv::Size& grid : grids) {
+            source.create(cv::Size(640, 360), CV_8UC3);
+            renderPattern(Pattern::HighMotion, 7, 30, source);
+            cv::Mat resized, gray;
+            std::string text;
+            resizeFrame(source, resized, gray, modes[m], grid);
+
+            const double rate = measureRate([&] {
+                convertFrame(resized, modes[m], text);
+                return text.empty() ? 0.0 : static_cast<double>(grid.area());
+            }, minSeconds);
+            out["convert_" + std::string(modeNames[m]) + "_" + std::to_string(grid.width)
+                + "x" + std::to_string(grid.height) + "_cells_per_sec"] = {rate, true};
+        }
+    }
+
+    for (const cv::Size& src : sources) {
+        source.create(src, CV_8UC3);
+        renderPattern(Pattern::GradientPan, 0, 30, source);
+        for (ColorMode mode : {ColorMode::None, ColorMode::Full}) {
+            cv::Mat resized, gray;
+            const double rate = measureRate([&] {
+                resizeFrame(source, resized, gray, mode, cv::Size(200, 120));
+                return 1.0;
+            }, minSeconds);
+            out["resize_" + std::string(mode == ColorMode::None ? "gray" : "color") + "_"
+                + std::to_string(src.height) + "p_200x120_fps"] = {rate, true};
+        }
+    }
+}
+
+// Decode + resize + encode every frame of a generated clip, as the player
+// does, minus the terminal
+bool measureEndToEnd(Metrics& out, double minSeconds) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "video2ascii_perf_gate";
+    fs::create_directories(dir);
+
+    for (Pattern pattern : {Pattern::TextScroll, Pattern::HighMotion, Pattern::Noise}) {
+        const std::string path = (dir / (std::string(patternName(pattern)) + ".avi")).string();
+        if (!fs::exists(path) && !writeCorpusVideo(path, pattern, cv::Size(1280, 720), 30, 60)) {
+            return false;
+        }
+
+        // Open + first decode + resize + encode, the player's critical path to
+        // its first frame; best of several runs to suppress cache effects
+        double ttffMs = INFINITY;
+        for (int run = 0; run < 5; run++) {
+            const auto start = Clock::now();
+            cv::VideoCapture cap(path);
+            cv::Mat frame, resized, gray;
+            std::string text;
+            if (!cap.read(frame)) { return false; }
+            resizeFrame(frame, resized, gray, ColorMode::Full, cv::Size(160, 60));
+            convertFrame(resized, ColorMode::Full, text);
+            ttffMs = std::min(ttffMs,
+                std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        out["ttff_" + std::string(patternName(pattern)) + "_ms"] = {ttffMs, false};
+
+        for (ColorMode mode : {ColorMode::None, ColorMode::Full}) {
+            const std::string prefix = "e2e_" + std::string(patternName(pattern)) + "_"
+                + (mode == ColorMode::None ? "none" : "full");
+            cv::Mat frame, resized, gray;
+            std::string text;
+
+            const double fps = measureRate([&] {
+                cv::VideoCapture cap(path);
+                double frames = 0;
+                while (cap.read(frame)) {
+                    resizeFrame(frame, resized, gray, mode, cv::Size(160, 60));
+                    convertFrame(resized, mode, text);
+                    frames += text.empty() ? 0 : 1;
+                }
+                return frames;
+            }, minSeconds);
+            out[prefix + "_fps"] = {fps, true};
+        }
+    }
+    return true;
+}
+
+/* --- Baseline I/O --- */
+
+namespace {
+
+// Just enough JSON for the baseline format: nested objects of numbers,
+// strings and booleans
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : s_(text) {}
+
+    bool parseBaseline(Baseline& baseline) {
+        return object([&](const std::string& key) {
+            if (key == "tolerance") { return number(baseline.tolerance); }
+            if (key == "tolerances") {
+                return object([&](const std::string& name) {
+                    return number(baseline.tolerances[name]);
+                });
+            }
+            if (key == "hosts") {
+                return object([&](const std::string& host) {
+                    return metrics(baseline.hosts[host]);
+                });
+            }
+            return skip();
+        });
+    }
+
+private:
+    bool metrics(Metrics& out) {
+        return object([&](const std::string& name) {
+            Metric& metric = out[name];
+            return object([&](const std::string& field) {
+                if (field == "value") { return number(metric.value); }
+                if (field == "higher_is_better") { return boolean(metric.higherIsBetter); }
+                return skip();
+            });
+        });
+    }
+
+    void ws() { while (i_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[i_]))) { i_++; } }
+    bool eat(char c) {
+        ws();
+        if (i_ < s_.size() && s_[i_] == c) { i_++; return true; }
+        return false;
+    }
+
+    bool string(std::string& out) {
+        if (!eat('"')) { return false; }
+        out.clear();
+        while (i_ < s_.size() && s_[i_] != '"') {
+            if (s_[i_] == '\\' && i_ + 1 < s_.size()) { i_++; }
+            out += s_[i_++];
+        }
+        return eat('"');
+    }
+
+    bool number(double& out) {
+        ws();
+        char* end = nullptr;
+        out = std::strtod(s_.c_str() + i_, &end);
+        if (end == s_.c_str() + i_) { return false; }
+        i_ = static_cast<size_t>(end - s_.c_str());
+        return true;
+    }
+
+    bool boolean(bool& out) {
+        ws();
+        if (s_.compare(i_, 4, "true") == 0)  { out = true;  i_ += 4; return true; }
+        if (s_.compare(i_, 5, "false") == 0) { out = false; i_ += 5; return true; }
+        return false;
+    }
+
+    bool object(const std::function<bool(const std::string&)>& member) {
+        if (!eat('{')) { return false; }
+        if (eat('}')) { return true; }
+        do {
+            std::string key;
+            if (!string(key) || !eat(':') || !member(key)) { return false; }
+        } while (eat(','));
+        return eat('}');
+    }
+
+    bool skip() {
+        ws();
+        if (i_ >= s_.size()) { return false; }
+        if (s_[i_] == '{') { return object([&](const std::string&) { return skip(); }); }
+        if (s_[i_] == '"') { std::string ignored; return string(ignored); }
+        if (s_[i_] == 't' || s_[i_] == 'f') { bool ignored; return boolean(ignored); }
+        double ignored;
+        return number(ignored);
+    }
+
+    const std::string& s_;
+    size_t i_ = 0;
+};
+
+}
+
+bool readBaseline(const std::string& path, Baseline& baseline) {
+    std::ifstream in(path);
+    if (!in) { return false; }
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string json = text.str();
+    return JsonReader(json).parseBaseline(baseline);
+}
+
+bool writeBaseline(const std::string& path, const Baseline& baseline) {
+    std::ofstream out(path);
+    if (!out) { return false; }
+
+    out << "{\n  \"tolerance\": " << baseline.tolerance << ",\n  \"tolerances\": {";
+    const char* sep = "\n";
+    for (const auto& [name, tolerance] : baseline.tolerances) {
+        out << sep << "    \"" << name << "\": " << tolerance;
+        sep = ",\n";
+    }
+    out << "\n  },\n  \"hosts\": {";
+
+    const char* hostSep = "\n";
+    for (const auto& [host, metrics] : baseline.hosts) {
+        out << hostSep << "    \"" << host << "\": {";
+        sep = "\n";
+        for (const auto& [name, metric] : metrics) {
+            char value[32];
+            std::snprintf(value, sizeof(value), "%.4g", metric.value);
+            out << sep << "      \"" << name << "\": {\"value\": " << value
+                << ", \"higher_is_better\": " << (metric.higherIsBetter ? "true" : "false")
+                << '}';
+            sep = ",\n";
+        }
+        out << "\n    }";
+        hostSep = ",\n";
+    }
+    out << "\n  }\n}\n";
+    return static_cast<bool>(out);
+}
+
+std::string hostName() {
+#ifdef _WIN32
+    const char* name = std::getenv("COMPUTERNAME");
+    return name ? name : "";
+#else
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) != 0) { return ""; }
+    return name;
+#endif
+}
+
+/* --- Options --- */
+
+int getGateOptions(GateOptions& opts, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        try {
+            if (strncmp(argv[i], "--baseline=", 11) == 0) {
+                opts.baselinePath = argv[i] + 11;
+            } else if (strncmp(argv[i], "--host=", 7) == 0) {
+                opts.host = argv[i] + 7;
+            } else if (strncmp(argv[i], "--tolerance=", 12) == 0) {
+                opts.tolerance = std::stod(argv[i] + 12);
+            } else if (strncmp(argv[i], "--min-time=", 11) == 0) {
+                opts.minSeconds = std::stod(argv[i] + 11);
+            } else if (strcmp(argv[i], "--update") == 0) {
+                opts.update = true;
+            } else {
+                std::cerr << "Usage: video2ascii_perf_gate --baseline=<file.json> [--host=<key>] "
+                          << "[--tolerance=<fraction>] [--min-time=<seconds>] [--update]\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid value for " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (opts.baselinePath.empty()) {
+        std::cerr << "Error: --baseline=<file.json> is required\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+#include "ascii.hpp"
+#include "corpus.hpp"
+#include "vt_screen.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// End-to-end rendering benchmark: encoded frames are written to the slave side
+// of a pseudo-terminal (so the kernel line discipline is in the path) while a
+// consumer thread drains the master side through a VT parser. Reports frames
+// per second, per-frame drain latency and bytes per frame.
+
+/* --- Custom Types --- */
+
+using Clock = std::chrono::steady_clock;
+
+enum class RenderStrategy : uint8_t {
+    Clear,      // "\x1b[2J\x1b[H" before every frame (the original player behaviour)
+    Home        // Cursor home only; each frame overwrites the previous one (current player)
+};
+
+struct PtyBenchOptions {
+    Pattern pattern     = Pattern::HighMotion;
+    int frames          = 300;
+    int width           = 160;
+    int height          = 60;
+    cv::Size source     = cv::Size(1280, 720);
+};
+
+struct PtyResult {
+    double fps;
+    double meanLatencyMs;
+    double p99LatencyMs;
+    double bytesPerFrame;
+};
+
+/* --- Function Prototypes --- */
+
+int getPtyBenchOptions(PtyBenchOptions& opts, int argc, char** argv);
+std::vector<std::string> encodeFrames(const PtyBenchOptions& opts, ColorMode mode,
+        RenderStrategy strategy);
+bool runPty(const std::vector<std::string>& frames, int cols, int rows, PtyResult& result);
+bool writeAll(int fd, const char* data, size_t len, const std::atomic<bool>& readerGone);
+
+/* --- Main --- */
+
+int main(int argc, char** argv) {
+    PtyBenchOptions opts;
+    if (getPtyBenchOptions(opts, argc, argv) == 1) {
+        return 1;
+    }
+
+    constexpr ColorMode modes[] = {ColorMode::None, ColorMode::ANSI, ColorMode::Full};
+    constexpr const char* modeNames[] = {"none", "ansi", "full"};
+    constexpr RenderStrategy strategies[] = {RenderStrategy::Clear, RenderStrategy::Home};
+    constexpr const char* strategyNames[] = {"clear", "home"};
+
+    std::printf("%-6s %-6s %10s %14s %13s %14s\n",
+                "color", "render", "fps", "latency_ms", "p99_ms", "bytes/frame");
+    for (size_t m = 0; m < std::size(modes); m++) {
+        for (size_t s = 0; s < std::size(strategies); s++) {
+            auto frames = encodeFrames(opts, modes[m], strategies[s]);
+            PtyResult r{};
+            if (!runPty(frames, opts.width, opts.height, r)) {
+                std::cerr << "Error: Could not run pseudo-terminal benchmark: "
+                          << std::strerror(errno) << '\n';
+                return 1;
+            }
+            std::printf("%-6s %-6s %10.1f %14.3f %13.3f %14.0f\n", modeNames[m],
+                        strategyNames[s], r.fps, r.meanLatencyMs, r.p99LatencyMs, r.bytesPerFrame);
+        }
+    }
+
+    return 0;
+}
+
+/* --- Function Definitions --- */
+
+int getPtyBenchOptions(PtyBenchOptions& opts, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        try {
+            if (strncmp(argv[i], "--pattern=", 10) == 0) {
+                if (!parsePattern(argv[i] + 10, opts.pattern)) {
+                    std::cerr << "Unknown pattern: " << argv[i] + 10 << '\n';
+                    return 1;
+                }
+            } else if (strncmp(argv[i], "--frames=", 9) == 0) {
+                opts.frames = std::stoi(argv[i] + 9);
+            } else if (strncmp(argv[i], "--width=", 8) == 0) {
+                opts.width = std::stoi(argv[i] + 8);
+            } else if (strncmp(argv[i], "--height=", 9) == 0) {
+                opts.height = std::stoi(argv[i] + 9);
+            } else {
+                std::cerr << "Usage: video2ascii_pty_bench [--pattern=<name>] [--frames=<n>] "
+                          << "[--width=<n>] [--height=<n>]\n";
+                return 1;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Invalid value for " << argv[i] << '\n';
+            return 1;
+        }
+    }
+
+    if (opts.frames < 1 || opts.width < 1 || opts.height < 1) {
+        std::cerr << "Error: Frame count and grid size must be positive\n";
+        return 1;
+    }
+    return 0;
+}
+
+std::vector<std::string> encodeFrames(const PtyBenchOptions& opts, ColorMode mode,
+        RenderStrategy strategy) {
+    const char* header = (strategy == RenderStrategy::Clear) ? "\x1b[2J\x1b[H" : "\x1b[H";
+    const cv::Size size(opts.width, opts.height);
+    cv::Mat frame(opts.source, CV_8UC3), gray, resized;
+    std::vector<std::string> frames;
+    frames.reserve(static_cast<size_t>(opts.frames));
+
+    for (int i = 0; i < opts.frames; i++) {
+        renderPattern(opts.pattern, i, 30, frame);
+        resizeFrame(frame, resized, gray, mode, size);
+        frames.push_back(header + convertFrame(resized, mode));
+    }
+    return frames;
+}
+
+// Write to the non-blocking `fd`, waiting while the pty is full. Fails once
+// the reader has gone, since nothing would drain the pty any more.
+bool writeAll(int fd, const char* data, size_t len, const std::atomic<bool>& readerGone) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) { return false; }
+            if (readerGone.load(std::memory_order_acquire)) {
+                errno = EPIPE;
+                return false;
+            }
+            pollfd pfd{fd, POLLOUT, 0};
+            poll(&pfd, 1, 100);
+            continue;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool runPty(const std::vector<std::string>& frames, int cols, int rows, PtyResult& result) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) { return false; }
+    const char* slaveName = grantpt(master) == 0 && unlockpt(master) == 0 ? ptsname(master)
+                                                                          : nullptr;
+    int slave = slaveName ? ::open(slaveName, O_WRONLY | O_NOCTTY | O_NONBLOCK) : -1;
+    if (slave < 0) {
+        const int error = errno;
+        ::close(master);
+        errno = error;
+        return false;
+    }
+
+    // One extra row so the trailing newline of the last line does not scroll
+    winsize ws{};
+    ws.ws_col = static_cast<unsigned short>(cols);
+    ws.ws_row = static_cast<unsigned short>(rows + 1);
+    ioctl(slave, TIOCSWINSZ, &ws);
+
+    // With ONLCR every '\n' becomes "\r\n" on the master side, so the parser
+    // only knows a frame has drained once it has consumed its translated size
+    std::vector<size_t> drainedAt(frames.size());
+    size_t total = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        total += frames[i].size() + static_cast<size_t>(std::count(frames[i].begin(), frames[i].end(), '\n'));
+        drainedAt[i] = total;
+    }
+
+    std::vector<Clock::time_point> submitted(frames.size()), drained(frames.size());
+    VtScreen screen(cols, rows + 1);
+    size_t next = 0;    // Frames fully drained
+    std::atomic<bool> readerGone{false};
+
+    std::thread consumer([&] {
+        std::vector<char> buf(1 << 16);
+        size_t consumed = 0;
+        while (next < frames.size()) {
+            ssize_t n = ::read(master, buf.data(), buf.size());
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) { continue; }
+                break;
+            }
+            screen.feed(buf.data(), static_cast<size_t>(n));
+            consumed += static_cast<size_t>(n);
+            const auto now = Clock::now();
+            while (next < frames.size() && drainedAt[next] <= consumed) {
+                drained[next++] = now;
+            }
+        }
+        readerGone.store(true, std::memory_order_release);
+    });
+
+    const auto start = Clock::now();
+    bool ok = true;
+    for (size_t i = 0; i < frames.size() && ok; i++) {
+        submitted[i] = Clock::now();
+        ok = writeAll(slave, frames[i].data(), frames[i].size(), readerGone);
+    }
+    if (!ok) { ::close(master); }  // Unblock the consumer
+    consumer.join();
+
+    ::close(slave);
+    if (ok) { ::close(master); }
+    // A reader that stopped early leaves frames without a drain time
+    if (ok && next != frames.size()) {
+        errno = EIO;
+        ok = false;
+    }
+    if (!ok) { return false; }
+    const auto end = drained.back();
+
+    std::vector<double> latencies(frames.size());
+    double sum = 0, bytes = 0;
+    for (size_t i = 0; i < frames.size(); i++) {
+        latencies[i] = std::chrono::duration<double, std::milli>(drained[i] - submitted[i]).count();
+        sum += latencies[i];
+        bytes += static_cast<double>(frames[i].size());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    result.fps = static_cast<double>(frames.size()) / seconds;
+    result.meanLatencyMs = sum / static_cast<double>(frames.size());
+    result.p99LatencyMs = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    result.bytesPerFrame = bytes / static_cast<double>(frames.size());
+    return true;
+}
@@ -0,0 +1,92 @@
+#include "reference.hpp"
+
+#include <sstream>
+
+/* --- Helpers --- */
+
+namespace {
+
+char refBrightnessToAscii(int brightness) {
+    int index = brightness * (asciiLen - 1) / 255;
+    return asciiChars[index];
+}
+
+const char* refAnsiColor(int r, int g, int b, int brightness) {
+    if (brightness < Color::DARK_THRESHOLD) { return Color::BLACK; }
+
+    int maxC = std::max({r, g, b});
+    int minC = std::min({r, g, b});
+    if (maxC - minC < Color::GRAYSCALE_VARIANCE) {
+        if (brightness > Color::VERY_BRIGHT) { return Color::BRIGHT_WHITE; }
+        if (brightness > Color::BRIGHT) { return Color::WHITE; }
+        return Color::BRIGHT_BLACK;
+    }
+
+    bool bright = brightness > Color::MEDIUM_BRIGHT;
+    if (r > g && r > b) { return bright ? Color::BRIGHT_RED : Color::RED; }
+    if (g > r && g > b) { return bright ? Color::BRIGHT_GREEN : Color::GREEN; }
+    if (b > r && b > g) { return bright ? Color::BRIGHT_BLUE : Color::BLUE; }
+
+    return Color::WHITE;
+}
+
+}
+
+/* --- Function Definitions --- */
+
+std::string referenceConvert(const cv::Mat& frame, ColorMode mode, cv::Size size) {
+    return referenceEncode(referenceResize(frame, mode, size), mode);
+}
+
+cv::Mat referenceResize(const cv::Mat& frame, ColorMode mode, cv::Size size) {
+    cv::Mat gray, resized;
+    if (mode == ColorMode::ANSI || mode == ColorMode::Full) {
+        cv::resize(frame, resized, size, 0, 0, cv::INTER_AREA);
+    } else {
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        cv::resize(gray, resized, size, 0, 0, cv::INTER_AREA);
+    }
+    return resized;
+}
+
+std::string referenceEncode(const cv::Mat& cells, ColorMode mode) {
+    const cv::Mat& resizedColor = cells;
+    const cv::Mat& resized = cells;
+    const cv::Size size = cells.size();
+    std::ostringstream frameStream;
+
+    for (int y = 0; y < size.height; y++) {
+        const cv::Vec3b* colorRowPtr = (mode != ColorMode::None)
+            ? resizedColor.ptr<cv::Vec3b>(y) : nullptr;
+        const uchar* grayRowPtr = (mode == ColorMode::None)
+            ? resized.ptr<uchar>(y) : nullptr;
+
+        for (int x = 0; x < size.width; x++) {
+            if (mode == ColorMode::ANSI) {
+                const cv::Vec3b& px = colorRowPtr[x];
+                uchar b = px[0], g = px[1], r = px[2];
+                int brightness = std::clamp((r + g + b) / 3, 0, 255);
+
+                frameStream << refAnsiColor(r, g, b, brightness);
+                frameStream << refBrightnessToAscii(brightness);
+                frameStream << Color::RESET;
+            } else if (mode == ColorMode::Full) {
+                const cv::Vec3b& px = colorRowPtr[x];
+                uchar b = px[0], g = px[1], r = px[2];
+                int brightness = std::clamp((r + g + b) / 3, 0, 255);
+
+                frameStream << Color::TRUECOLOR << static_cast<int>(r) << ';'
+                            << static_cast<int>(g) << ';' << static_cast<int>(b) << 'm'
+                            << refBrightnessToAscii(brightness) << Color::RESET;
+            } else {
+                uchar px = grayRowPtr[x];
+                int brightness = std::clamp(static_cast<int>(px), 0, 255);
+                int index = brightness * (asciiLen - 1) / 255;
+                frameStream << asciiChars[index];
+            }
+        }
+        frameStream << '\n';
+    }
+
+    return frameStream.str();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "ascii.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <string>
+
+// Frozen copy of the original scalar resize + encode loop from loadFrames().
+// Optimized kernels are validated against this, so it must never be changed
+// to track them.
+std::string referenceConvert(const cv::Mat& frame, ColorMode mode, cv::Size size);
+
+// The two halves of referenceConvert: the resize to cells (BGR, or luma for
+// ColorMode::None), and the encode of any cells to text
+cv::Mat referenceResize(const cv::Mat& frame, ColorMode mode, cv::Size size);
+std::string referenceEncode(const cv::Mat& cells, ColorMode mode);
@@ -0,0 +1,46 @@
+# Source classification check: a URL with a query string is opened as a
+# video stream, not globbed as an image sequence, while a wildcard path
+# still is. The URLs point at a closed local port, so each open fails fast;
+# the error tells which way the input was taken.
+#
+#   cmake -DPLAYER=<video2ascii> -P source_kind.cmake
+
+if(NOT PLAYER)
+    message(FATAL_ERROR "Usage: cmake -DPLAYER=<video2ascii> -P source_kind.cmake")
+endif()
+
+set(VIDEO_ERROR "Could not open video")
+set(IMAGES_ERROR "No images found")
+
+# Input and the error its open must end in
+set(CASES
+    "rtsp://127.0.0.1:1/stream?channel=1|${VIDEO_ERROR}"
+    "http://127.0.0.1:1/live.m3u8?token=abc|${VIDEO_ERROR}"
+    "http://127.0.0.1:1/frames/*.png|${VIDEO_ERROR}"
+    "${CMAKE_CURRENT_BINARY_DIR}/source_kind_missing/frame_?.png|${IMAGES_ERROR}"
+)
+
+set(failures 0)
+foreach(case IN LISTS CASES)
+    string(REPLACE "|" ";" parts "${case}")
+    list(GET parts 0 input)
+    list(GET parts 1 expected)
+
+    execute_process(
+        COMMAND ${PLAYER} ${input}
+        RESULT_VARIABLE result
+        OUTPUT_QUIET
+        ERROR_VARIABLE errors
+        TIMEOUT 30)
+    string(FIND "${errors}" "${expected}" found)
+    if(result EQUAL 0 OR found EQUAL -1)
+        message(SEND_ERROR "${input}: expected \"${expected}\", got (exit ${result})\n${errors}")
+        math(EXPR failures "${failures} + 1")
+    else()
+        message(STATUS "${input}: ${expected}")
+    endif()
+endforeach()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${failures} source classification failure(s)")
+endif()
@@ -0,0 +1,143 @@
+#include "vt_screen.hpp"
+
+#include <algorithm>
+
+/* --- Function Definitions --- */
+
+uint32_t vtBasicColor(int sgr) {
+    // xterm default palette
+    static constexpr uint32_t normal[8] = {
+        0x000000, 0xCD0000, 0x00CD00, 0xCDCD00, 0x0000EE, 0xCD00CD, 0x00CDCD, 0xE5E5E5
+    };
+    static constexpr uint32_t bright[8] = {
+        0x7F7F7F, 0xFF0000, 0x00FF00, 0xFFFF00, 0x5C5CFF, 0xFF00FF, 0x00FFFF, 0xFFFFFF
+    };
+    if (sgr >= 30 && sgr <= 37) { return normal[sgr - 30]; }
+    if (sgr >= 90 && sgr <= 97) { return bright[sgr - 90]; }
+    return VtCell::DEFAULT_FG;
+}
+
+VtScreen::VtScreen(int cols, int rows)
+    : cols_(cols), rows_(rows), cells_(static_cast<size_t>(cols) * rows) {}
+
+void VtScreen::reset() {
+    std::fill(cells_.begin(), cells_.end(), VtCell{});
+    cx_ = cy_ = 0;
+    fg_ = VtCell::DEFAULT_FG;
+    clears_ = 0;
+    state_ = State::Ground;
+    params_.clear();
+    param_ = -1;
+}
+
+void VtScreen::feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        const char c = data[i];
+        switch (state_) {
+            case State::Ground:
+                if (c == '\x1b')      { state_ = State::Escape; }
+                else if (c == '\n')   { lineFeed(); }
+                else if (c == '\r')   { cx_ = 0; }
+                else if (c >= 0x20 && c < 0x7f) { put(c); }
+                break;
+            case State::Escape:
+                if (c == '[') {
+                    state_ = State::Csi;
+                    params_.clear();
+                    param_ = -1;
+                } else {
+                    state_ = State::Ground;
+                }
+                break;
+            case State::Csi:
+                if (c >= '0' && c <= '9') {
+                    param_ = (param_ < 0 ? 0 : param_ * 10) + (c - '0');
+                } else if (c == ';') {
+                    params_.push_back(param_);
+                    param_ = -1;
+                } else if (c >= 0x40 && c <= 0x7e) {
+                    params_.push_back(param_);
+                    dispatchCsi(c);
+                    state_ = State::Ground;
+                }
+                break;
+        }
+    }
+}
+
+void VtScreen::put(char c) {
+    if (cx_ >= cols_) {
+        cx_ = 0;
+        lineFeed();
+    }
+    VtCell& cell = cells_[static_cast<size_t>(cy_) * cols_ + cx_];
+    cell.ch = c;
+    cell.fg = fg_;
+    cx_++;
+}
+
+void VtScreen::lineFeed() {
+    if (cy_ + 1 < rows_) {
+        cy_++;
+        return;
+    }
+    // Scroll up one line
+    std::move(cells_.begin() + cols_, cells_.end(), cells_.begin());
+    std::fill(cells_.end() - cols_, cells_.end(), VtCell{});
+}
+
+void VtScreen::dispatchCsi(char final) {
+    auto param = [this](size_t i, int fallback) {
+        return (i < params_.size() && params_[i] >= 0) ? params_[i] : fallback;
+    };
+
+    switch (final) {
+        case 'H':
+        case 'f':
+            cy_ = std::clamp(param(0, 1) - 1, 0, rows_ - 1);
+            cx_ = std::clamp(param(1, 1) - 1, 0, cols_ - 1);
+            break;
+        case 'J':
+            switch (param(0, 0)) {
+                case 0: erase(cx_, cy_, cols_, rows_ - 1); break;
+                case 1: erase(0, 0, cx_ + 1, cy_); break;
+                default: erase(0, 0, cols_, rows_ - 1); clears_++; break;
+            }
+            break;
+        case 'K':
+            switch (param(0, 0)) {
+                case 0: erase(cx_, cy_, cols_, cy_); break;
+                case 1: erase(0, cy_, cx_ + 1, cy_); break;
+                default: erase(0, cy_, cols_, cy_); break;
+            }
+            break;
+        case 'm':
+            applySgr();
+            break;
+        default:
+            break;
+    }
+}
+
+void VtScreen::applySgr() {
+    for (size_t i = 0; i < params_.size(); i++) {
+        int p = params_[i] < 0 ? 0 : params_[i];
+        if (p == 0 || p == 39) {
+            fg_ = VtCell::DEFAULT_FG;
+        } else if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97)) {
+            fg_ = vtBasicColor(p);
+        } else if (p == 38 && i + 4 < params_.size() && params_[i + 1] == 2) {
+            auto channel = [](int v) { return static_cast<uint32_t>(std::clamp(v, 0, 255)); };
+            fg_ = (channel(params_[i + 2]) << 16) | (channel(params_[i + 3]) << 8) | channel(params_[i + 4]);
+            i += 4;
+        }
+    }
+}
+
+// Erase from (fromX, fromY) up to but excluding (toX, toY) in reading order
+void VtScreen::erase(int fromX, int fromY, int toX, int toY) {
+    size_t begin = static_cast<size_t>(fromY) * cols_ + std::min(fromX, cols_);
+    size_t end = static_cast<size_t>(toY) * cols_ + std::min(toX, cols_);
+    std::fill(cells_.begin() + static_cast<long>(std::min(begin, cells_.size())),
+              cells_.begin() + static_cast<long>(std::min(end, cells_.size())), VtCell{});
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal VT/xterm output parser that maintains a virtual screen. It
+// understands exactly the subset video2ascii emits (printable ASCII, CR/LF,
+// CUP, ED, EL and SGR foreground colors), which is enough to measure the
+// consumer side of the escape stream and to recover the cell grid from it.
+
+struct VtCell {
+    char ch          = ' ';
+    uint32_t fg      = DEFAULT_FG;  // 0xRRGGBB, or DEFAULT_FG
+
+    static constexpr uint32_t DEFAULT_FG = 0xFFFFFFFFu;
+};
+
+class VtScreen {
+public:
+    VtScreen(int cols, int rows);
+
+    void feed(const char* data, size_t len);
+    void reset();
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    const VtCell& at(int x, int y) const { return cells_[static_cast<size_t>(y) * cols_ + x]; }
+
+    // Number of ED (clear screen) sequences seen, used to count frames
+    uint64_t clears() const { return clears_; }
+
+private:
+    enum class State : uint8_t { Ground, Escape, Csi };
+
+    void put(char c);
+    void lineFeed();
+    void dispatchCsi(char final);
+    void applySgr();
+    void erase(int fromX, int fromY, int toX, int toY);
+
+    int cols_, rows_;
+    std::vector<VtCell> cells_;
+    int cx_ = 0, cy_ = 0;
+    uint32_t fg_ = VtCell::DEFAULT_FG;
+    uint64_t clears_ = 0;
+
+    State state_ = State::Ground;
+    std::vector<int> params_;
+    int param_ = -1;
+};
+
+// Map the 16 basic SGR foreground codes (30-37, 90-97) to RGB
+uint32_t vtBasicColor(int sgr);
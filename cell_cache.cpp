@@ -0,0 +1,63 @@
+#include "cell_cache.hpp"
+
+#include <cstdio>
+
+/* --- Function Definitions --- */
+
+std::string loopStreamReason(size_t frames, cv::Size grid, ColorMode mode, bool playlist,
+        bool interactive) {
+    if (playlist) { return "a playlist"; }
+    if (interactive) { return "--interactive"; }
+    if (frames == 0) { return "frame count unknown"; }
+
+    const size_t bytes = CellCache::bytesFor(frames, grid, mode);
+    if (bytes <= LOOP_CACHE_BYTES) { return std::string(); }
+    char why[96];
+    std::snprintf(why, sizeof(why), "cells would take %.1f MB of %zu MB",
+        bytes / 1048576.0, LOOP_CACHE_BYTES >> 20);
+    return why;
+}
+
+/* --- CellCache --- */
+
+size_t CellCache::bytesFor(size_t frames, cv::Size grid, ColorMode mode) {
+    const size_t channels = mode == ColorMode::None ? 1 : 3;
+    return frames * static_cast<size_t>(grid.area()) * channels;
+}
+
+CellCache::CellCache(size_t frames, cv::Size grid, ColorMode mode)
+    : block_(static_cast<int>(frames) * grid.height, grid.width,
+             mode == ColorMode::None ? CV_8UC1 : CV_8UC3),
+      slots_(new Slot[frames]), count_(frames) {
+    for (size_t i = 0; i < count_; i++) {
+        const int top = static_cast<int>(i) * grid.height;
+        slots_[i].cells = block_.rowRange(top, top + grid.height);
+    }
+}
+
+void CellCache::store(size_t index, const cv::Mat& cells, uint32_t generation) {
+    if (index >= count_) {
+        spoiled_.store(true, std::memory_order_relaxed);
+        return;
+    }
+    Slot& slot = slots_[index];
+    if (!cells.empty() && (cells.size() != slot.cells.size() || cells.type() != slot.cells.type())) {
+        spoiled_.store(true, std::memory_order_relaxed);
+        return;
+    }
+    // Into the slot's rows, which copyTo keeps as the sizes match
+    if (!cells.empty()) { cells.copyTo(slot.cells); }
+    slot.blank = cells.empty();
+    slot.generation = generation;
+    slot.stored = true;
+}
+
+bool CellCache::complete(size_t frames, uint32_t generation) const {
+    if (spoiled_.load(std::memory_order_relaxed) || frames == 0 || frames > count_) {
+        return false;
+    }
+    for (size_t i = 0; i < frames; i++) {
+        if (!slots_[i].stored || slots_[i].generation != generation) { return false; }
+    }
+    return true;
+}
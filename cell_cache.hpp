@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ascii.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <string>
+
+// Frames of a looping clip kept as cells: the resized frame, one pixel per
+// character. Passes after the first encode them again without decoding or
+// resizing. A cell is 1 byte in grayscale and 3 in color, a fraction of its
+// encoded text, and the cells stay valid whatever --hud or the sinks do.
+
+// Largest cache --loop keeps; longer clips are streamed again each pass
+constexpr size_t LOOP_CACHE_BYTES = size_t(256) << 20;
+
+// Why --loop has to stream every pass rather than replay the first from
+// cells, or an empty string if `frames` frames (0 if unknown) of `grid` can
+// be kept. A playlist or --interactive shows other frames each pass.
+std::string loopStreamReason(size_t frames, cv::Size grid, ColorMode mode, bool playlist,
+        bool interactive);
+
+class CellCache {
+public:
+    // Bytes that `frames` frames of `grid` take in `mode`
+    static size_t bytesFor(size_t frames, cv::Size grid, ColorMode mode);
+
+    // Room for `frames` frames of `grid`, allocated up front in one block
+    CellCache(size_t frames, cv::Size grid, ColorMode mode);
+
+    // First pass, any worker: keep the cells of frame `index`, converted for
+    // grid `generation`. Empty cells mark a frame that could not be read. A
+    // frame beyond the room, or of another size, spoils the cache.
+    void store(size_t index, const cv::Mat& cells, uint32_t generation);
+
+    // After a first pass of `frames` frames: true if every one was kept, and
+    // converted for grid `generation`
+    bool complete(size_t frames, uint32_t generation) const;
+
+    const cv::Mat& cells(size_t index) const { return slots_[index].cells; }
+    bool blank(size_t index) const { return slots_[index].blank; }
+    size_t bytes() const { return block_.total() * block_.elemSize(); }
+
+private:
+    struct Slot {
+        cv::Mat cells;          // Rows of block_
+        uint32_t generation = 0;
+        bool stored = false;
+        bool blank = false;
+    };
+
+    cv::Mat block_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t count_;
+    std::atomic<bool> spoiled_{false};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Live pipeline counters, updated with relaxed atomic adds. Several threads
+// may add to the same field (every conversion worker adds to framesConverted,
+// convertNs and the resize and encode histograms), so no field has a single
+// writer. Any thread may sample them without locking (HUD, metrics export);
+// readers derive rates and queue depths from deltas of monotonic counts, and
+// fields read one after another are not a consistent snapshot.
+
+// Fixed-bucket latency histogram. Bucket counts are not cumulative; the last
+// bucket catches everything above the largest bound.
+struct LatencyHistogram {
+    static constexpr uint64_t BOUNDS_NS[] = {
+        100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000,
+        10'000'000, 25'000'000, 50'000'000, 100'000'000, 250'000'000
+    };
+    static constexpr int BUCKETS = sizeof(BOUNDS_NS) / sizeof(BOUNDS_NS[0]) + 1;
+
+    std::atomic<uint64_t> counts[BUCKETS] = {};
+    std::atomic<uint64_t> sumNs{0};
+
+    void observe(uint64_t ns) {
+        int i = 0;
+        while (i < BUCKETS - 1 && ns > BOUNDS_NS[i]) { i++; }
+        counts[i].fetch_add(1, std::memory_order_relaxed);
+        sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+};
+
+// Why the player skipped a converted frame
+enum class DropReason : uint8_t {
+    Late,       // Its slot had passed and a newer frame was ready
+    Resized,    // Converted for a grid the terminal no longer has
+    Superseded  // Live: a newer frame was ready
+};
+
+constexpr int DROP_REASON_COUNT = 3;
+
+struct PipelineCounters {
+    std::atomic<uint64_t> framesDecoded{0};     // Put in the decode queue (live: the mailbox)
+    std::atomic<uint64_t> framesDispatched{0};  // Taken from it for conversion
+    std::atomic<uint64_t> framesConverted{0};   // Converted and ready to present
+    std::atomic<uint64_t> framesReady{0};       // Published to the frame ring, blank ones too
+    std::atomic<uint64_t> framesPresented{0};
+    std::atomic<uint64_t> framesDropped[DROP_REASON_COUNT] = {};  // By DropReason
+    std::atomic<uint64_t> framesStale{0};       // Live: replaced by a newer capture before conversion
+    std::atomic<uint64_t> framesLate{0};        // Presented, but well into their slot
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<uint64_t> convertNs{0};         // Resize + encode time
+    std::atomic<uint64_t> writeNs{0};           // Terminal write + flush time
+
+    LatencyHistogram decodeLatency;
+    LatencyHistogram resizeLatency;
+    LatencyHistogram encodeLatency;
+    LatencyHistogram writeLatency;
+    LatencyHistogram captureToDisplay;          // Source frame available until written
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+    static uint64_t get(const std::atomic<uint64_t>& counter) {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    void drop(DropReason reason) { add(framesDropped[static_cast<int>(reason)], 1); }
+    uint64_t dropped(DropReason reason) const { return get(framesDropped[static_cast<int>(reason)]); }
+    uint64_t droppedTotal() const {
+        uint64_t n = 0;
+        for (const auto& count : framesDropped) { n += get(count); }
+        return n;
+    }
+};
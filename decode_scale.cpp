@@ -0,0 +1,51 @@
+#include "decode_scale.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+
+namespace {
+
+constexpr int MAX_DECODE_SCALE = 8;
+
+}
+
+/* --- Decode Scale --- */
+
+int chooseDecodeScale(cv::Size source, cv::Size grid) {
+    int scale = 1;
+    while (scale < MAX_DECODE_SCALE) {
+        const cv::Size next = reducedSize(source, scale * 2);
+        if (next.width < grid.width * MIN_SAMPLES_PER_CELL ||
+            next.height < grid.height * MIN_SAMPLES_PER_CELL) {
+            break;
+        }
+        scale *= 2;
+    }
+    return scale;
+}
+
+cv::Size reducedSize(cv::Size source, int scale) {
+    return cv::Size((source.width + scale - 1) / scale, (source.height + scale - 1) / scale);
+}
+
+cv::Rect reducedRect(cv::Rect rect, int scale, cv::Size reduced) {
+    const int x0 = rect.x / scale, y0 = rect.y / scale;
+    const int x1 = std::min(reduced.width, (rect.x + rect.width + scale - 1) / scale);
+    const int y1 = std::min(reduced.height, (rect.y + rect.height + scale - 1) / scale);
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+int reducedImreadFlags(int scale) {
+    switch (scale) {
+        case 2: return cv::IMREAD_REDUCED_COLOR_2;
+        case 4: return cv::IMREAD_REDUCED_COLOR_4;
+        case 8: return cv::IMREAD_REDUCED_COLOR_8;
+    }
+    return cv::IMREAD_COLOR;
+}
+
+int lowresLevel(int scale) {
+    int level = 0;
+    while ((1 << level) < scale) { level++; }
+    return level;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+// Reduced-resolution decoding. Some decoders can produce a 1/2, 1/4 or 1/8
+// scale image for much less work than a full one: JPEG by DCT scaling
+// (cv::IMREAD_REDUCED_*), and FFmpeg decoders that implement `lowres`
+// (MJPEG and a few older codecs, but not H.264 or HEVC). When the grid is
+// far smaller than the source, the full-resolution detail is averaged away
+// by the resize anyway.
+
+// Source pixels kept across each cell in both directions, so the final area
+// resample still averages rather than point-samples
+constexpr int MIN_SAMPLES_PER_CELL = 2;
+
+// Largest power-of-two reduction (1, 2, 4 or 8) that keeps at least
+// MIN_SAMPLES_PER_CELL source pixels per grid cell
+int chooseDecodeScale(cv::Size source, cv::Size grid);
+
+// Size a decoder produces at 1/scale (dimensions round up)
+cv::Size reducedSize(cv::Size source, int scale);
+
+// `rect` of a full-size frame in the frame decoded at 1/scale, rounded
+// outwards and kept inside `reduced`
+cv::Rect reducedRect(cv::Rect rect, int scale, cv::Size reduced);
+
+// cv::imread flags for a color decode at 1/scale
+int reducedImreadFlags(int scale);
+
+// FFmpeg `lowres` level for 1/scale: log2(scale)
+int lowresLevel(int scale);
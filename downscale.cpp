@@ -0,0 +1,89 @@
+#include "downscale.hpp"
+
+#include <algorithm>
+
+/* --- Helpers --- */
+
+namespace {
+
+// Source bytes handled per column tile. The tile's 16-bit accumulators
+// (8 KB) stay in L1 while `factor` source rows are added into them.
+constexpr int TILE_BYTES = 4096;
+
+// Body for cv::parallel_for_ over output rows (a loop body object rather
+// than a lambda, so dispatching it never allocates)
+class BoxReducer : public cv::ParallelLoopBody {
+public:
+    BoxReducer(const cv::Mat& src, cv::Mat& dst, int factor)
+        : src_(src), dst_(dst), factor_(factor) {}
+
+    void operator()(const cv::Range& range) const override {
+        const int cn = src_.channels();
+        int shift = 0;
+        while ((1 << shift) < factor_ * factor_) { shift++; }
+        const unsigned half = (1u << shift) >> 1;
+        const int groupBytes = factor_ * cn;    // Source bytes per output pixel in a row
+        const int tileGroups = std::max(1, TILE_BYTES / groupBytes);
+        uint16_t acc[TILE_BYTES];
+
+        for (int y = range.start; y < range.end; y++) {
+            uchar* out = dst_.ptr<uchar>(y);
+            for (int g0 = 0; g0 < dst_.cols; g0 += tileGroups) {
+                const int groups = std::min(tileGroups, dst_.cols - g0);
+                const int bytes = groups * groupBytes;
+                const size_t offset = static_cast<size_t>(g0) * groupBytes;
+
+                // Vertical: add `factor` rows byte by byte. Contiguous and
+                // branch-free, so the compiler vectorizes it.
+                const uchar* row = src_.ptr<uchar>(y * factor_) + offset;
+                for (int i = 0; i < bytes; i++) { acc[i] = row[i]; }
+                for (int r = 1; r < factor_; r++) {
+                    row = src_.ptr<uchar>(y * factor_ + r) + offset;
+                    for (int i = 0; i < bytes; i++) { acc[i] = static_cast<uint16_t>(acc[i] + row[i]); }
+                }
+
+                // Horizontal: add `factor` pixels per channel, on data
+                // already reduced `factor` times
+                uchar* o = out + static_cast<size_t>(g0) * cn;
+                for (int g = 0; g < groups; g++) {
+                    const uint16_t* a = acc + g * groupBytes;
+                    for (int c = 0; c < cn; c++) {
+                        unsigned sum = 0;
+                        for (int k = 0; k < factor_; k++) { sum += a[k * cn + c]; }
+                        o[g * cn + c] = static_cast<uchar>((sum + half) >> shift);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const cv::Mat& src_;
+    cv::Mat& dst_;
+    int factor_;
+};
+
+}
+
+/* --- Function Definitions --- */
+
+int pyramidFactor(cv::Size source, cv::Size target, ResizeMethod method) {
+    if (method == ResizeMethod::Area) { return 1; }
+
+    int factor = 1;
+    while (factor < PYRAMID_MAX_FACTOR &&
+           source.width / (factor * 2) >= target.width * PYRAMID_MIN_SAMPLES &&
+           source.height / (factor * 2) >= target.height * PYRAMID_MIN_SAMPLES) {
+        factor *= 2;
+    }
+    if (method == ResizeMethod::Auto && factor < PYRAMID_MIN_FACTOR) { return 1; }
+    return factor;
+}
+
+void boxReduce(const cv::Mat& src, cv::Mat& dst, int factor) {
+    CV_Assert(src.depth() == CV_8U && (src.channels() == 1 || src.channels() == 3));
+    CV_Assert(factor >= 1 && factor <= PYRAMID_MAX_FACTOR && (factor & (factor - 1)) == 0);
+
+    dst.create(src.rows / factor, src.cols / factor, src.type());
+    cv::parallel_for_(cv::Range(0, dst.rows), BoxReducer(src, dst, factor));
+}
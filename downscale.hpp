@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+
+// Box-pyramid downscaling for sources far larger than the grid. A direct
+// INTER_AREA resample from 4K or 8K to a couple of hundred columns takes
+// OpenCV's general (non-integer) area path over the whole frame. Reducing by
+// a power of two first is an integer box filter, which is cheap, streams
+// through the frame once and leaves a small image for the final area
+// resample. The result approximates INTER_AREA: cell edges snap to the box
+// grid, so it is not bit-identical.
+
+enum class ResizeMethod : uint8_t {
+    Auto,       // Pyramid when the source is at least PYRAMID_MIN_FACTOR x 2 per cell
+    Area,       // INTER_AREA straight to the grid (exact reference behavior)
+    Pyramid     // Pyramid whenever one level fits
+};
+
+// Pixels per cell kept for the final area resample, in both directions
+constexpr int PYRAMID_MIN_SAMPLES = 2;
+// Smallest box factor Auto bothers with
+constexpr int PYRAMID_MIN_FACTOR = 4;
+// Largest box factor; keeps the 16-bit accumulators from overflowing
+constexpr int PYRAMID_MAX_FACTOR = 16;
+
+// Box factor (1, 2, 4, 8 or 16) `method` uses to take `source` to `target`
+// before the final resample; 1 means resample directly
+int pyramidFactor(cv::Size source, cv::Size target, ResizeMethod method);
+
+// Average each factor x factor block of an 8-bit, 1 or 3 channel image
+// (factor a power of two up to PYRAMID_MAX_FACTOR). This is what repeated
+// 2x box reductions compute, in one pass without the intermediate levels.
+// Rows and columns past the last whole block are dropped.
+void boxReduce(const cv::Mat& src, cv::Mat& dst, int factor);
@@ -0,0 +1,149 @@
+#include "executor.hpp"
+
+#include <algorithm>
+
+/* --- Globals --- */
+
+namespace {
+
+thread_local Executor* tlsExecutor = nullptr;
+
+int64_t tickOf(Executor::Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count()
+        / Executor::TIMER_TICK.count();
+}
+
+}
+
+Executor* currentExecutor() {
+    return tlsExecutor;
+}
+
+void postJob(Executor* executor, Job* job) {
+    executor->post(job);
+}
+
+/* --- Task --- */
+
+void Task::promise_type::Finish::await_suspend(
+        std::coroutine_handle<promise_type> h) noexcept {
+    TaskGroup* group = h.promise().group;
+    h.destroy();
+    group->finished();
+}
+
+void TaskGroup::finished() {
+    notifying_.fetch_add(1, std::memory_order_acq_rel);
+    if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) { idle_.notify(); }
+    notifying_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+/* --- Executor --- */
+
+Executor::Executor(int threads) : runQueue_(RUN_QUEUE_DEPTH) {
+    nextTick_ = tickOf(Clock::now());
+    for (int i = 0; i < threads; i++) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+    timerThread_ = std::thread([this] { timerLoop(); });
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        stopping_ = true;
+    }
+    timerWake_.notify_one();
+    timerThread_.join();
+
+    runQueue_.close();
+    for (std::thread& worker : workers_) { worker.join(); }
+}
+
+void Executor::spawn(Task task, TaskGroup& group) {
+    auto handle = std::exchange(task.handle_, {});
+    Task::promise_type& promise = handle.promise();
+    promise.group = &group;
+    promise.run = [](Job* job) {
+        auto& p = *static_cast<Task::promise_type*>(job);
+        std::coroutine_handle<Task::promise_type>::from_promise(p).resume();
+    };
+    group.live_.fetch_add(1, std::memory_order_acq_rel);
+    post(&promise);
+}
+
+void Executor::post(Job* job) {
+    runQueue_.push(job);
+}
+
+void Executor::workerLoop() {
+    tlsExecutor = this;
+    Job* job = nullptr;
+    while (runQueue_.pop(job)) { job->run(job); }
+}
+
+/* --- Timer Wheel --- */
+
+void Executor::addTimer(TimerNode* node) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex_);
+        // Anything already due fires on the next pass
+        const int64_t tick = std::max(tickOf(node->deadline), nextTick_);
+        TimerNode*& slot = wheel_[static_cast<size_t>(tick) % WHEEL_SLOTS];
+        node->next = slot;
+        slot = node;
+        timerCount_++;
+    }
+    timerWake_.notify_one();
+}
+
+void Executor::timerLoop() {
+    std::unique_lock<std::mutex> lock(timerMutex_);
+    while (!stopping_) {
+        // Expire every slot up to now; a slot holds deadlines from later
+        // laps of the wheel too, so only due nodes are taken
+        const auto now = Clock::now();
+        const int64_t nowTick = tickOf(now);
+        TimerNode* due = nullptr;
+        const int64_t last = std::min(nowTick, nextTick_ + static_cast<int64_t>(WHEEL_SLOTS) - 1);
+        for (int64_t tick = nextTick_; tick <= last; tick++) {
+            for (TimerNode** link = &wheel_[static_cast<size_t>(tick) % WHEEL_SLOTS]; *link;) {
+                TimerNode* node = *link;
+                if (node->deadline <= now) {
+                    *link = node->next;
+                    node->next = due;
+                    due = node;
+                    timerCount_--;
+                } else {
+                    link = &node->next;
+                }
+            }
+        }
+        nextTick_ = nowTick;
+
+        if (due) {
+            lock.unlock();
+            while (due) {
+                TimerNode* next = due->next;
+                post(due);
+                due = next;
+            }
+            lock.lock();
+            continue;
+        }
+
+        // Sleep until the earliest pending deadline. Only a few timers are
+        // ever pending, so a full sweep is cheap.
+        if (timerCount_ == 0) {
+            timerWake_.wait(lock);
+            continue;
+        }
+        auto wakeAt = Clock::time_point::max();
+        for (TimerNode* slot : wheel_) {
+            for (TimerNode* node = slot; node; node = node->next) {
+                wakeAt = std::min(wakeAt, node->deadline);
+            }
+        }
+        timerWake_.wait_until(lock, wakeAt);
+    }
+}
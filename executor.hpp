@@ -0,0 +1,154 @@
+#pragma once
+
+#include "mpmc_queue.hpp"
+#include "waiter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Small coroutine runtime for the playback pipeline: a fixed thread pool
+// draining a lock-free run queue, plus a timer wheel for presentation
+// deadlines. Pipeline stages are coroutines that suspend on queue and timer
+// awaits instead of blocking threads, so a stage or sink costs a coroutine
+// frame, not a thread.
+
+class TaskGroup;
+
+// Fire-and-forget coroutine started with Executor::spawn(). It starts
+// suspended so the executor decides where it runs, and its frame frees
+// itself when the body returns. Exceptions terminate.
+class Task {
+public:
+    struct promise_type : Job {
+        // Frees the frame, then reports the task to its group
+        struct Finish {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+
+        TaskGroup* group = nullptr;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        Finish final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    ~Task() { if (handle_) { handle_.destroy(); } }
+
+private:
+    friend class Executor;
+    explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Tasks spawned together. join() blocks a thread; `co_await wait()` suspends
+// a coroutine until every task in the group has returned.
+class TaskGroup {
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup() {
+        // The last task may still be inside notify() after join() returns
+        while (notifying_.load(std::memory_order_acquire) > 0) { std::this_thread::yield(); }
+    }
+
+    void join() {
+        idle_.wait([this] { return live_.load(std::memory_order_acquire) == 0; }, 0);
+    }
+    auto wait() {
+        return WaitFor(idle_, [this]() -> std::optional<bool> {
+            if (live_.load(std::memory_order_acquire) == 0) { return true; }
+            return std::nullopt;
+        });
+    }
+
+private:
+    friend class Executor;
+    friend class Task;
+
+    void finished();
+
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> notifying_{0};
+    Waiter idle_;
+};
+
+class Executor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Timer wheel resolution and span; later deadlines wrap around
+    static constexpr auto TIMER_TICK = std::chrono::milliseconds(1);
+    static constexpr size_t WHEEL_SLOTS = 256;
+    // Each live coroutine has at most one job queued, so this bounds the
+    // number of coroutines an executor can run at once
+    static constexpr size_t RUN_QUEUE_DEPTH = 256;
+
+    explicit Executor(int threads);
+    ~Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Run `task` on the pool as part of `group`
+    void spawn(Task task, TaskGroup& group);
+
+    // Queue a job; safe from any thread
+    void post(Job* job);
+
+    // `co_await executor.sleepUntil(t)` resumes on the pool at or after `t`
+    auto sleepUntil(Clock::time_point deadline) {
+        struct Sleep : TimerNode {
+            Executor& executor;
+            Sleep(Executor& e, Clock::time_point t) : executor(e) { deadline = t; }
+            bool await_ready() const { return Clock::now() >= deadline; }
+            void await_suspend(std::coroutine_handle<> h) {
+                handle = h;
+                executor.addTimer(this);
+            }
+            void await_resume() {}
+        };
+        return Sleep(*this, deadline);
+    }
+
+private:
+    struct TimerNode : Job {
+        Clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        TimerNode* next = nullptr;
+
+        TimerNode() { run = [](Job* job) { static_cast<TimerNode*>(job)->handle.resume(); }; }
+    };
+
+    void addTimer(TimerNode* node);
+    void workerLoop();
+    void timerLoop();
+
+    MpmcQueue<Job*> runQueue_;
+    std::vector<std::thread> workers_;
+
+    // Timer wheel: slot = deadline tick % WHEEL_SLOTS
+    std::mutex timerMutex_;
+    std::condition_variable timerWake_;
+    TimerNode* wheel_[WHEEL_SLOTS] = {};
+    size_t timerCount_ = 0;
+    int64_t nextTick_ = 0;      // First tick not yet expired
+    bool stopping_ = false;
+    std::thread timerThread_;
+};
@@ -0,0 +1,80 @@
+#include "frame_pool.hpp"
+
+#include <algorithm>
+#include <new>
+
+/* --- Helpers --- */
+
+namespace {
+
+size_t alignUp(size_t n) {
+    return (n + FramePool::ALIGNMENT - 1) & ~(FramePool::ALIGNMENT - 1);
+}
+
+size_t rowStep(cv::Size size, int type) {
+    return alignUp(static_cast<size_t>(size.width) * CV_ELEM_SIZE(type));
+}
+
+size_t imageBytes(cv::Size size, int type) {
+    return rowStep(size, type) * static_cast<size_t>(size.height);
+}
+
+// Carve an image out of the arena at `offset` and advance past it
+cv::Mat carve(uchar* arena, size_t& offset, cv::Size size, int type) {
+    cv::Mat image(size, type, arena + offset, rowStep(size, type));
+    offset += imageBytes(size, type);
+    return image;
+}
+
+}
+
+/* --- FramePool --- */
+
+FramePool::FramePool(size_t count, cv::Size source, const std::vector<cv::Size>& regions,
+        cv::Size grid, ColorMode mode)
+    : buffers_(count), free_(count) {
+    const bool gray = (mode == ColorMode::None);
+    const int gridType = gray ? CV_8UC1 : CV_8UC3;
+
+    // A smaller region may keep a smaller pyramid factor and so leave a
+    // larger reduced image; Pyramid reduces whenever any method would
+    cv::Size content, reduced;
+    for (cv::Size region : regions) {
+        content.width = std::max(content.width, region.width);
+        content.height = std::max(content.height, region.height);
+        const int factor = pyramidFactor(region, grid, ResizeMethod::Pyramid);
+        if (factor == 1) { continue; }
+        reduced.width = std::max(reduced.width, region.width / factor);
+        reduced.height = std::max(reduced.height, region.height / factor);
+    }
+    const bool pyramid = reduced.area() > 0;
+
+    const size_t perFrame = imageBytes(source, CV_8UC3)
+        + (gray ? imageBytes(content, CV_8UC1) : 0)
+        + (pyramid ? imageBytes(reduced, CV_8UC3) : 0)
+        + imageBytes(grid, gridType);
+    arenaBytes_ = perFrame * count;
+    arena_.reset(static_cast<uchar*>(::operator new(arenaBytes_, std::align_val_t(ALIGNMENT))));
+
+    size_t offset = 0;
+    for (FrameBuffers& b : buffers_) {
+        b.source = carve(arena_.get(), offset, source, CV_8UC3);
+        if (gray) { b.luma = carve(arena_.get(), offset, content, CV_8UC1); }
+        if (pyramid) { b.reduced = carve(arena_.get(), offset, reduced, CV_8UC3); }
+        b.downscaled = carve(arena_.get(), offset, grid, gridType);
+        free_.push(&b);
+    }
+}
+
+FrameBuffers* FramePool::borrow() {
+    FrameBuffers* buffers = nullptr;
+    return free_.pop(buffers) ? buffers : nullptr;
+}
+
+void FramePool::giveBack(FrameBuffers* buffers) {
+    free_.push(buffers);
+}
+
+void FramePool::close() {
+    free_.close();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ascii.hpp"
+#include "mpmc_queue.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// Image buffers for one in-flight frame. All three are headers over the
+// pool's arena; OpenCV writes into them in place as long as the sizes match.
+struct FrameBuffers {
+    cv::Mat source;         // Decoded BGR frame
+    std::chrono::steady_clock::time_point captured;     // When `source` became available
+    cv::Mat luma;           // Grayscale content (ColorMode::None only)
+    cv::Mat reduced;        // Box-pyramid output (see downscale.hpp); empty if never used
+    cv::Mat downscaled;     // Grid-sized BGR or luma image
+};
+
+// Fixed set of pre-allocated frame buffers that pipeline stages borrow and
+// return, so steady-state streaming performs no image allocations and memory
+// is bounded by count x frame size. Every image starts and every row is
+// padded to a 64-byte boundary.
+class FramePool {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    // `regions` are the sizes of the part of each source frame that may be
+    // resized (the crop at each zoom level, see viewport.hpp); scratch
+    // images are sized for the largest need of any of them
+    FramePool(size_t count, cv::Size source, const std::vector<cv::Size>& regions,
+        cv::Size grid, ColorMode mode);
+
+    // Wait for a free set of buffers. Returns nullptr once closed.
+    FrameBuffers* borrow();
+    // Coroutine borrow: yields std::nullopt once closed
+    auto borrowAsync() { return free_.popAsync(); }
+    void giveBack(FrameBuffers* buffers);
+    void close();
+
+    size_t bytes() const { return arenaBytes_; }
+
+private:
+    struct AlignedDelete {
+        void operator()(uchar* p) const { ::operator delete(p, std::align_val_t(ALIGNMENT)); }
+    };
+
+    size_t arenaBytes_ = 0;
+    std::unique_ptr<uchar[], AlignedDelete> arena_;
+    std::vector<FrameBuffers> buffers_;
+    MpmcQueue<FrameBuffers*> free_;
+};
@@ -0,0 +1,32 @@
+#include "frame_ring.hpp"
+
+FrameRing::FrameRing(size_t capacity, size_t segments, size_t segmentBytes)
+    : capacity_(capacity), slots_(new Slot[capacity]) {
+    for (size_t i = 0; i < capacity_; i++) {
+        slots_[i].frame.segments.resize(segments);
+        for (std::string& s : slots_[i].frame.segments) { s.reserve(segmentBytes); }
+    }
+}
+
+void FrameRing::publish(uint64_t seq) {
+    slots_[seq % capacity_].ready.store(seq, std::memory_order_release);
+    published_.notify();
+}
+
+void FrameRing::pop() {
+    head_.fetch_add(1, std::memory_order_release);
+    released_.notify();
+}
+
+size_t FrameRing::size() const {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    size_t n = 0;
+    while (n < capacity_ && isReady(head + n)) { n++; }
+    return n;
+}
+
+void FrameRing::close() {
+    closed_.store(true, std::memory_order_release);
+    published_.notify();
+    released_.notify();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "waiter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Encoded text of one frame as row bands, written back to back. Frames
+// converted whole have a single segment.
+struct FrameText {
+    std::vector<std::string> segments;
+    std::chrono::steady_clock::time_point captured;     // Of the source frame
+    uint32_t generation = 0;    // Of the grid it was converted for (see grid_target.hpp)
+    std::chrono::steady_clock::duration period{};       // How long it stays on screen
+
+    size_t size() const {
+        size_t n = 0;
+        for (const std::string& s : segments) { n += s.size(); }
+        return n;
+    }
+};
+
+// Fixed ring of reusable frame buffers between the conversion workers and the
+// player. Frame `seq` always lands in slot seq % capacity, so workers that
+// finish out of order encode straight into their slot and the ring itself is
+// the reorder stage: the player only ever sees frames in sequence. Frame text
+// is never copied or allocated during playback, and no call takes a lock.
+// Waiting calls are awaitables for the pipeline coroutines (see WaitFor).
+class FrameRing {
+public:
+    // Each slot holds `segments` segments reserved to `segmentBytes` up front
+    FrameRing(size_t capacity, size_t segments, size_t segmentBytes);
+
+    // Producers: `co_await acquire(seq)` waits until frame `seq` fits in the
+    // ring and yields its slot, or nullptr once closed
+    auto acquire(uint64_t seq) {
+        return WaitFor(released_, [this, seq]() -> std::optional<FrameText*> {
+            if (closed_.load(std::memory_order_acquire)) { return nullptr; }
+            if (seq < head_.load(std::memory_order_acquire) + capacity_) {
+                return &slots_[seq % capacity_].frame;
+            }
+            return std::nullopt;
+        });
+    }
+    // Producers: frame `seq` is fully written
+    void publish(uint64_t seq);
+
+    // Consumer: `co_await front()` waits for the next frame in sequence and
+    // yields it, or nullptr once the ring is closed and drained
+    auto front() {
+        return WaitFor(published_, [this]() -> std::optional<const FrameText*> {
+            const uint64_t head = head_.load(std::memory_order_relaxed);
+            if (isReady(head)) { return &slots_[head % capacity_].frame; }
+            if (closed_.load(std::memory_order_acquire)) {
+                return isReady(head) ? &slots_[head % capacity_].frame : nullptr;
+            }
+            return std::nullopt;
+        });
+    }
+    // Consumer: release the slot returned by front()
+    void pop();
+
+    // Frames ready in sequence but not yet popped
+    size_t size() const;
+
+    // True once either side has closed the ring
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // Either side: no more frames will be produced or consumed. Producers
+    // must all have finished publishing before closing from their side.
+    void close();
+
+private:
+    static constexpr uint64_t EMPTY = ~uint64_t(0);
+
+    struct alignas(64) Slot {
+        FrameText frame;
+        std::atomic<uint64_t> ready{EMPTY};     // Sequence number published here
+    };
+
+    bool isReady(uint64_t seq) const {
+        return slots_[seq % capacity_].ready.load(std::memory_order_acquire) == seq;
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<uint64_t> head_{0};     // Next frame to present
+    std::atomic<bool> closed_{false};
+
+    Waiter published_, released_;
+};
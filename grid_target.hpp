@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <opencv2/core.hpp>
+
+// The character grid frames are converted for, which follows the terminal
+// size. Each change starts a new generation: converters read the target
+// once per frame and stamp the frame with its generation, so the player can
+// discard frames converted for a grid the terminal no longer has. Nothing
+// upstream of the resize depends on the grid, so decoding carries on.
+class GridTarget {
+public:
+    struct Grid {
+        cv::Size size;
+        uint32_t generation;
+    };
+
+    explicit GridTarget(cv::Size size) : packed_(pack({size, 0})) {}
+
+    Grid load() const { return unpack(packed_.load(std::memory_order_acquire)); }
+
+    // Retarget to `size`; a new generation only if it differs
+    void set(cv::Size size) {
+        const Grid current = load();
+        if (size == current.size) { return; }
+        packed_.store(pack({size, current.generation + 1}), std::memory_order_release);
+    }
+
+private:
+    // Generation, width and height (up to 65535) in one word, so they are
+    // read together
+    static uint64_t pack(Grid g) {
+        return (static_cast<uint64_t>(g.generation) << 32) |
+               (static_cast<uint64_t>(g.size.width & 0xffff) << 16) |
+               static_cast<uint64_t>(g.size.height & 0xffff);
+    }
+
+    static Grid unpack(uint64_t bits) {
+        return {cv::Size(static_cast<int>((bits >> 16) & 0xffff), static_cast<int>(bits & 0xffff)),
+                static_cast<uint32_t>(bits >> 32)};
+    }
+
+    std::atomic<uint64_t> packed_;
+};
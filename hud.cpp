@@ -0,0 +1,134 @@
+#include "hud.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+/* --- Constants --- */
+
+namespace {
+
+constexpr auto SAMPLE_INTERVAL = std::chrono::milliseconds(250);
+
+// Unchanged cells shorter than this between two changed runs are rewritten
+// rather than skipped, since a cursor move costs about as many bytes
+constexpr int MIN_SKIP = 8;
+
+// Longest status text, before padding to the width, and cursor move
+constexpr size_t TEXT_MAX = 160;
+constexpr size_t CUP_MAX = 32;
+
+double perFrameMs(uint64_t ns, uint64_t frames) {
+    return frames > 0 ? static_cast<double>(ns) / 1e6 / static_cast<double>(frames) : 0.0;
+}
+
+}
+
+/* --- Hud --- */
+
+Hud::Hud(int row, int width, ColorMode mode)
+    : row_(row), width_(width), mode_(mode), shown_(static_cast<size_t>(width), ' ') {
+    line_.reserve(std::max(static_cast<size_t>(width), TEXT_MAX));
+    last_.time = Clock::now();
+}
+
+void Hud::move(int row, int width) {
+    row_ = row;
+    width_ = width;
+    shown_.assign(static_cast<size_t>(width), ' ');
+    line_.reserve(std::max(static_cast<size_t>(width), TEXT_MAX));
+    drawn_ = false;
+}
+
+Hud::Sample Hud::sample(const PipelineCounters& counters) const {
+    Sample s;
+    s.time = Clock::now();
+    s.presented = PipelineCounters::get(counters.framesPresented);
+    s.dropped = counters.droppedTotal();
+    s.bytes = PipelineCounters::get(counters.bytesWritten);
+    s.convertNs = PipelineCounters::get(counters.convertNs);
+    s.writeNs = PipelineCounters::get(counters.writeNs);
+
+    // A queue's depth is what went in less what came out. The far end is
+    // read first so the depth can lag but not go negative; the min() covers
+    // a count added to just before its item was handed on.
+    const uint64_t taken = PipelineCounters::get(counters.framesDispatched) +
+        PipelineCounters::get(counters.framesStale);
+    const uint64_t decoded = PipelineCounters::get(counters.framesDecoded);
+    s.decodeQueued = decoded - std::min(decoded, taken);
+    const uint64_t played = s.presented + s.dropped;
+    const uint64_t ready = PipelineCounters::get(counters.framesReady);
+    s.ringQueued = ready - std::min(ready, played);
+    s.converted = PipelineCounters::get(counters.framesConverted);
+    return s;
+}
+
+void Hud::update(const PipelineCounters& counters, std::string& out) {
+    const Sample now = sample(counters);
+    if (drawn_ && now.time - last_.time < SAMPLE_INTERVAL) { return; }
+
+    format(now, line_);
+    // Room for the longest diff up front, so `out` only grows on first use
+    out.reserve(out.size() + maxDiffBytes());
+    appendDiff(line_, out);
+    last_ = now;
+    drawn_ = true;
+}
+
+void Hud::format(const Sample& now, std::string& line) const {
+    const double seconds = std::chrono::duration<double>(now.time - last_.time).count();
+    const uint64_t presented = now.presented - last_.presented;
+    const uint64_t converted = now.converted - last_.converted;
+
+    // Fall back to lifetime averages when a stage was idle this interval
+    const double convertMs = converted > 0
+        ? perFrameMs(now.convertNs - last_.convertNs, converted)
+        : perFrameMs(now.convertNs, now.converted);
+    const double writeMs = presented > 0
+        ? perFrameMs(now.writeNs - last_.writeNs, presented)
+        : perFrameMs(now.writeNs, now.presented);
+    const double kbPerFrame = presented > 0
+        ? static_cast<double>(now.bytes - last_.bytes) / 1024.0 / static_cast<double>(presented)
+        : 0.0;
+    char text[TEXT_MAX];
+    std::snprintf(text, sizeof(text),
+                  " fps %5.1f | dropped %llu | convert %6.2f ms | write %6.2f ms"
+                  " | queued: decode %llu ring %llu | %6.1f KB/frame",
+                  seconds > 0 ? static_cast<double>(presented) / seconds : 0.0,
+                  static_cast<unsigned long long>(now.dropped), convertMs, writeMs,
+                  static_cast<unsigned long long>(now.decodeQueued),
+                  static_cast<unsigned long long>(now.ringQueued), kbPerFrame);
+
+    line.assign(text);
+    line.resize(static_cast<size_t>(width_), ' ');
+}
+
+void Hud::appendDiff(const std::string& line, std::string& out) {
+    int x = 0;
+    while (x < width_) {
+        if (line[x] == shown_[x]) {
+            x++;
+            continue;
+        }
+
+        // Extend the run until MIN_SKIP consecutive cells are unchanged
+        int end = x + 1, same = 0;
+        for (int i = end; i < width_ && same < MIN_SKIP; i++) {
+            same = (line[i] == shown_[i]) ? same + 1 : 0;
+            if (same == 0) { end = i + 1; }
+        }
+
+        char cup[CUP_MAX];
+        std::snprintf(cup, sizeof(cup), "\x1b[%d;%dH", row_, x + 1);
+        out += cup;
+        convertText(line.data() + x, static_cast<size_t>(end - x), mode_, out);
+        x = end;
+    }
+    shown_ = line;
+}
+
+// Every run of changed cells costs a cursor move and its color framing, and
+// runs are at least MIN_SKIP unchanged cells apart
+size_t Hud::maxDiffBytes() const {
+    const size_t width = static_cast<size_t>(width_);
+    return width + (width / (MIN_SKIP + 1) + 1) * (CUP_MAX + maxTextBytes(mode_, 0));
+}
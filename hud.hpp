@@ -0,0 +1,47 @@
+#pragma once
+
+#include "ascii.hpp"
+#include "counters.hpp"
+
+#include <chrono>
+#include <string>
+
+// One-line status overlay drawn below the frame. Metrics are re-sampled from
+// PipelineCounters a few times per second, and only the cells that changed
+// since the last draw are emitted, so an idle HUD costs no output bytes.
+// Changed runs are encoded as text cells in the frame's color mode
+// (convertText) and go out in the same gathered write as the frame.
+class Hud {
+public:
+    Hud(int row, int width, ColorMode mode);
+
+    // Append the escape sequences that bring the status line up to date
+    void update(const PipelineCounters& counters, std::string& out);
+
+    // Move to a new row and width after the screen was cleared; the next
+    // update draws the whole line
+    void move(int row, int width);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample {
+        Clock::time_point time;
+        uint64_t converted = 0, presented = 0, dropped = 0, bytes = 0;
+        uint64_t convertNs = 0, writeNs = 0;
+        uint64_t decodeQueued = 0;      // Decoded, not yet taken for conversion
+        uint64_t ringQueued = 0;        // Converted, waiting in the frame ring
+    };
+
+    Sample sample(const PipelineCounters& counters) const;
+    void format(const Sample& now, std::string& line) const;
+    void appendDiff(const std::string& line, std::string& out);
+    size_t maxDiffBytes() const;
+
+    int row_, width_;
+    ColorMode mode_;
+    std::string shown_;
+    std::string line_;                  // Reused by format(), so updates do not allocate
+    Sample last_;
+    bool drawn_ = false;
+};
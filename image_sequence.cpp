@@ -0,0 +1,88 @@
+#include "image_sequence.hpp"
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+// Extensions picked up when the sequence is given as a directory
+constexpr const char* IMAGE_EXTENSIONS[] = {
+    ".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff", ".webp", ".ppm", ".pgm", ".exr"
+};
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// A `scheme://` prefix (RFC 3986 scheme characters) marks a URL, whose `?`
+// starts a query string rather than a wildcard
+bool hasUrlScheme(const std::string& path) {
+    const size_t end = path.find("://");
+    if (end == std::string::npos || end == 0) { return false; }
+    if (!std::isalpha(static_cast<unsigned char>(path[0]))) { return false; }
+    return std::all_of(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(end),
+        [](unsigned char c) { return std::isalnum(c) || c == '+' || c == '-' || c == '.'; });
+}
+
+bool hasImageExtension(const std::string& path) {
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return std::find(std::begin(IMAGE_EXTENSIONS), std::end(IMAGE_EXTENSIONS), ext)
+        != std::end(IMAGE_EXTENSIONS);
+}
+
+}
+
+/* --- Image Sequences --- */
+
+bool isImageSequence(const std::string& path) {
+    if (hasUrlScheme(path)) { return false; }
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) { return true; }
+    return path.find_first_of("*?") != std::string::npos;
+}
+
+std::vector<std::string> listImageSequence(const std::string& path) {
+    std::vector<std::string> files;
+    cv::glob(path, files, false);
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec)) {
+        files.erase(std::remove_if(files.begin(), files.end(),
+            [](const std::string& f) { return !hasImageExtension(f); }), files.end());
+    }
+    std::sort(files.begin(), files.end(), naturalLess);
+    return files;
+}
+
+bool naturalLess(const std::string& a, const std::string& b) {
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isDigit(a[i]) && isDigit(b[j])) {
+            // Compare digit runs by value: skip leading zeros, then the
+            // longer run is larger, then the first differing digit decides
+            size_t iEnd = i, jEnd = j;
+            while (iEnd < a.size() && isDigit(a[iEnd])) { iEnd++; }
+            while (jEnd < b.size() && isDigit(b[jEnd])) { jEnd++; }
+            size_t iStart = i, jStart = j;
+            while (iStart + 1 < iEnd && a[iStart] == '0') { iStart++; }
+            while (jStart + 1 < jEnd && b[jStart] == '0') { jStart++; }
+
+            if (iEnd - iStart != jEnd - jStart) { return iEnd - iStart < jEnd - jStart; }
+            const int cmp = a.compare(iStart, iEnd - iStart, b, jStart, jEnd - jStart);
+            if (cmp != 0) { return cmp < 0; }
+            i = iEnd;
+            j = jEnd;
+        } else {
+            if (a[i] != b[j]) { return a[i] < b[j]; }
+            i++;
+            j++;
+        }
+    }
+    if (a.size() - i != b.size() - j) { return a.size() - i < b.size() - j; }
+    // Equal up to zero padding: fall back to plain order so sorting is strict
+    return a < b;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Still images (e.g. numbered PNG/JPEG renders) played back as a video.
+
+// True if `path` names an image sequence: a directory, or a pattern with
+// wildcards in its file name such as `renders/frame_*.png`. A URL
+// (`scheme://...`) never does, query string or not.
+bool isImageSequence(const std::string& path);
+
+// Files of the sequence in playback order. A directory yields the image
+// files in it. Names are ordered with digit runs compared as numbers, so
+// frame_9.png plays before frame_10.png, padded or not.
+std::vector<std::string> listImageSequence(const std::string& path);
+
+// Filename order used by listImageSequence
+bool naturalLess(const std::string& a, const std::string& b);
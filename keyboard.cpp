@@ -0,0 +1,91 @@
+#include "keyboard.hpp"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* --- Helpers --- */
+
+namespace {
+
+// Key for a plain character, if it is one of ours
+bool charKey(char c, Key& key) {
+    switch (c) {
+        case 'k': case 'w': key = Key::Up;      return true;
+        case 'j': case 's': key = Key::Down;    return true;
+        case 'h': case 'a': key = Key::Left;    return true;
+        case 'l': case 'd': key = Key::Right;   return true;
+        case '+': case '=': key = Key::ZoomIn;  return true;
+        case '-': case '_': key = Key::ZoomOut; return true;
+        case '0':           key = Key::Reset;   return true;
+        case 'q': case 'Q': key = Key::Quit;    return true;
+    }
+    return false;
+}
+
+// Key for the final byte of an arrow escape (ESC [ A or ESC O A)
+bool arrowKey(char c, Key& key) {
+    switch (c) {
+        case 'A': key = Key::Up;    return true;
+        case 'B': key = Key::Down;  return true;
+        case 'C': key = Key::Right; return true;
+        case 'D': key = Key::Left;  return true;
+    }
+    return false;
+}
+
+}
+
+/* --- Keyboard --- */
+
+Keyboard::~Keyboard() {
+    close();
+}
+
+bool Keyboard::open() {
+#ifdef _WIN32
+    return false;
+#else
+    if (open_) { return true; }
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_) != 0) { return false; }
+
+    // Reads return at once with whatever has been typed
+    termios raw = saved_;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) { return false; }
+    open_ = true;
+    return true;
+#endif
+}
+
+void Keyboard::close() {
+#ifndef _WIN32
+    if (!open_) { return; }
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved_);
+    open_ = false;
+#endif
+}
+
+size_t Keyboard::read(Key* keys, size_t max) {
+#ifdef _WIN32
+    return 0;
+#else
+    if (!open_) { return 0; }
+    char buf[64];
+    const ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+
+    size_t count = 0;
+    for (ssize_t i = 0; i < n && count < max; i++) {
+        Key key;
+        if (buf[i] == '\x1b' && i + 2 < n && (buf[i + 1] == '[' || buf[i + 1] == 'O')) {
+            if (arrowKey(buf[i + 2], key)) { keys[count++] = key; }
+            i += 2;
+        } else if (charKey(buf[i], key)) {
+            keys[count++] = key;
+        }
+    }
+    return count;
+#endif
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <termios.h>
+#endif
+
+// Key presses from the terminal for interactive controls. While open, the
+// terminal is in non-canonical mode without echo, so keys arrive as they are
+// pressed and do not print over the frame. Ctrl-C still raises SIGINT.
+
+enum class Key : uint8_t {
+    Up,
+    Down,
+    Left,
+    Right,
+    ZoomIn,
+    ZoomOut,
+    Reset,
+    Quit
+};
+
+class Keyboard {
+public:
+    Keyboard() = default;
+    ~Keyboard();
+    Keyboard(const Keyboard&) = delete;
+    Keyboard& operator=(const Keyboard&) = delete;
+
+    // False if standard input is not a terminal (or on Windows)
+    bool open();
+    // Restore the terminal
+    void close();
+
+    // Up to `max` keys pressed since the last call, without waiting.
+    // Arrows, hjkl and wasd pan; + and - zoom; 0 resets; q quits.
+    size_t read(Key* keys, size_t max);
+
+private:
+#ifndef _WIN32
+    termios saved_{};
+#endif
+    bool open_ = false;
+};
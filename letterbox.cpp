@@ -0,0 +1,76 @@
+#include "letterbox.hpp"
+
+#include <vector>
+
+/* --- Helpers --- */
+
+namespace {
+
+bool isLit(const uchar* pixel, int cn) {
+    for (int c = 0; c < cn; c++) {
+        if (pixel[c] > BAR_BLACK_LEVEL) { return true; }
+    }
+    return false;
+}
+
+// Lit pixels allowed in a bar line of `length` pixels
+int maxLitInBar(int length) {
+    return static_cast<int>(length * BAR_MAX_LIT_SHARE);
+}
+
+// Region of one frame inside its bars; empty if nothing is lit
+cv::Rect frameContent(const cv::Mat& frame) {
+    const int cn = frame.channels();
+
+    // Rows first, then columns over the rows that hold content only, so the
+    // side bars of a windowboxed frame are measured against the picture
+    int top = -1, bottom = -1;
+    for (int y = 0; y < frame.rows; y++) {
+        const uchar* row = frame.ptr<uchar>(y);
+        int lit = 0;
+        for (int x = 0; x < frame.cols; x++) { lit += isLit(row + x * cn, cn); }
+        if (lit > maxLitInBar(frame.cols)) {
+            if (top < 0) { top = y; }
+            bottom = y;
+        }
+    }
+    if (top < 0) { return cv::Rect(); }
+
+    std::vector<int> columnLit(frame.cols, 0);
+    for (int y = top; y <= bottom; y++) {
+        const uchar* row = frame.ptr<uchar>(y);
+        for (int x = 0; x < frame.cols; x++) { columnLit[x] += isLit(row + x * cn, cn); }
+    }
+    const int limit = maxLitInBar(bottom - top + 1);
+    int left = 0, right = frame.cols - 1;
+    while (left < right && columnLit[left] <= limit) { left++; }
+    while (right > left && columnLit[right] <= limit) { right--; }
+
+    return cv::Rect(left, top, right - left + 1, bottom - top + 1);
+}
+
+}
+
+/* --- BorderDetector --- */
+
+BorderDetector::BorderDetector(cv::Size frameSize) : size_(frameSize) {}
+
+void BorderDetector::add(const cv::Mat& frame) {
+    if (frame.size() != size_ || frame.depth() != CV_8U) { return; }
+
+    const cv::Rect content = frameContent(frame);
+    if (content.empty()) { return; }
+
+    content_ = samples_ == 0 ? content : (content_ | content);
+    samples_++;
+}
+
+cv::Rect BorderDetector::content() const {
+    const cv::Rect whole(0, 0, size_.width, size_.height);
+    if (samples_ == 0 ||
+        content_.width < size_.width * MIN_CONTENT_SHARE ||
+        content_.height < size_.height * MIN_CONTENT_SHARE) {
+        return whole;
+    }
+    return content_;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+
+// Letterbox and pillarbox detection. Footage with black bars baked in would
+// otherwise spend grid cells, conversion work and output bytes on solid
+// black. Bars are found by sampling frames: a border is only cropped if it
+// is black in every sample, so a dark scene does not eat into the picture.
+
+// A pixel is lit if any channel is above this (compressed black is not 0)
+constexpr int BAR_BLACK_LEVEL = 32;
+// A row or column is part of a bar if at most this share of it is lit,
+// which tolerates noise and stray bright pixels in the bars
+constexpr double BAR_MAX_LIT_SHARE = 0.02;
+// Smallest content, as a share of each dimension, that is trusted as a crop
+constexpr double MIN_CONTENT_SHARE = 0.25;
+
+class BorderDetector {
+public:
+    explicit BorderDetector(cv::Size frameSize);
+
+    // Fold in an 8-bit, 1 or 3 channel frame. Frames of another size, and
+    // frames with nothing lit (fades, black title cards), are ignored.
+    void add(const cv::Mat& frame);
+
+    // The region inside the bars of every sample, or the whole frame if
+    // there were no usable samples or the bars would leave too little
+    cv::Rect content() const;
+
+    int samples() const { return samples_; }
+
+private:
+    cv::Size size_;
+    cv::Rect content_;
+    int samples_ = 0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "waiter.hpp"
+
+#include <atomic>
+#include <optional>
+
+// Single-slot handoff that keeps only the newest item. A producer that
+// outpaces the consumer replaces the waiting item instead of queueing behind
+// it, which is what a live source wants: a stale frame is worth nothing.
+template <typename T>
+class Mailbox {
+public:
+    // Leave `item` for the consumer. Returns the unread item it displaced,
+    // or nullptr.
+    T* put(T* item) {
+        T* displaced = slot_.exchange(item, std::memory_order_acq_rel);
+        ready_.notify();
+        return displaced;
+    }
+
+    // Coroutine take: yields the newest item, or nullptr once closed and empty
+    auto takeAsync() {
+        return WaitFor(ready_, [this]() -> std::optional<T*> {
+            if (T* item = slot_.exchange(nullptr, std::memory_order_acq_rel)) { return item; }
+            if (closed_.load(std::memory_order_acquire)) {
+                return slot_.exchange(nullptr, std::memory_order_acq_rel);
+            }
+            return std::nullopt;
+        });
+    }
+
+    // Take whatever is left without waiting
+    T* take() { return slot_.exchange(nullptr, std::memory_order_acq_rel); }
+
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        ready_.notify();
+    }
+
+private:
+    std::atomic<T*> slot_{nullptr};
+    std::atomic<bool> closed_{false};
+    Waiter ready_;
+};
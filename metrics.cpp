@@ -0,0 +1,259 @@
+#include "metrics.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/* --- Helpers --- */
+
+namespace {
+
+constexpr auto EXPORT_INTERVAL = std::chrono::seconds(1);
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+
+// "[host]:port" with a numeric port; anything else is treated as a path. A
+// port outside 1-65535, however many digits it has, leaves `port` at 0.
+bool parseAddress(const std::string& target, std::string& host, int& port) {
+    size_t colon = target.rfind(':');
+    if (colon == std::string::npos || colon + 1 == target.size()) { return false; }
+    for (size_t i = colon + 1; i < target.size(); i++) {
+        if (!std::isdigit(static_cast<unsigned char>(target[i]))) { return false; }
+    }
+    host = target.substr(0, colon);
+    if (host.empty() || host == "localhost") { host = "127.0.0.1"; }
+    const char* last = target.data() + target.size();
+    const auto [end, error] = std::from_chars(target.data() + colon + 1, last, port);
+    if (error != std::errc() || end != last || port < 1 || port > 65535) { port = 0; }
+    return true;
+}
+
+void appendCounter(std::string& out, const char* name, const char* help, uint64_t value) {
+    out += "# HELP video2ascii_"; out += name; out += ' '; out += help;
+    out += "\n# TYPE video2ascii_"; out += name; out += " counter\nvideo2ascii_";
+    out += name; out += ' '; out += std::to_string(value); out += '\n';
+}
+
+// `labels` is either empty or a label list with a trailing comma, e.g. `stage="decode",`
+void appendHistogram(std::string& out, const char* name, const char* labels,
+        const LatencyHistogram& h) {
+    char line[200];
+    uint64_t cumulative = 0;
+    for (int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+        cumulative += h.counts[i].load(std::memory_order_relaxed);
+        if (i < LatencyHistogram::BUCKETS - 1) {
+            std::snprintf(line, sizeof(line), "video2ascii_%s_bucket{%sle=\"%g\"} %llu\n",
+                          name, labels, static_cast<double>(LatencyHistogram::BOUNDS_NS[i]) / 1e9,
+                          static_cast<unsigned long long>(cumulative));
+        } else {
+            std::snprintf(line, sizeof(line), "video2ascii_%s_bucket{%sle=\"+Inf\"} %llu\n",
+                          name, labels, static_cast<unsigned long long>(cumulative));
+        }
+        out += line;
+    }
+
+    // The sum and count carry the labels without the trailing comma
+    std::string braced(labels);
+    if (!braced.empty()) { braced = '{' + braced.substr(0, braced.size() - 1) + '}'; }
+    std::snprintf(line, sizeof(line),
+                  "video2ascii_%s_sum%s %.9f\n"
+                  "video2ascii_%s_count%s %llu\n",
+                  name, braced.c_str(), static_cast<double>(h.sumNs.load(std::memory_order_relaxed)) / 1e9,
+                  name, braced.c_str(), static_cast<unsigned long long>(cumulative));
+    out += line;
+}
+
+}
+
+/* --- Function Definitions --- */
+
+std::string formatMetrics(const PipelineCounters& counters) {
+    std::string out;
+    out.reserve(4096);
+
+    appendCounter(out, "frames_converted_total", "Frames converted and ready to present.",
+                  PipelineCounters::get(counters.framesConverted));
+    appendCounter(out, "frames_presented_total", "Frames written to the terminal.",
+                  PipelineCounters::get(counters.framesPresented));
+
+    out += "# HELP video2ascii_frames_dropped_total Converted frames the player skipped: late "
+           "(slot passed, newer frame ready), resized (converted for a previous grid), "
+           "superseded (live, newer frame ready).\n"
+           "# TYPE video2ascii_frames_dropped_total counter\n";
+    constexpr std::pair<DropReason, const char*> reasons[] = {
+        {DropReason::Late, "late"}, {DropReason::Resized, "resized"},
+        {DropReason::Superseded, "superseded"}
+    };
+    for (const auto& [reason, label] : reasons) {
+        out += "video2ascii_frames_dropped_total{reason=\"";
+        out += label;
+        out += "\"} ";
+        out += std::to_string(counters.dropped(reason));
+        out += '\n';
+    }
+    appendCounter(out, "frames_stale_total", "Live captures replaced by a newer one before conversion.",
+                  PipelineCounters::get(counters.framesStale));
+    appendCounter(out, "frames_late_total", "Frames presented more than half a period late.",
+                  PipelineCounters::get(counters.framesLate));
+    appendCounter(out, "bytes_written_total", "Bytes written to the terminal.",
+                  PipelineCounters::get(counters.bytesWritten));
+
+    out += "# HELP video2ascii_stage_latency_seconds Per-frame latency of each pipeline stage.\n"
+           "# TYPE video2ascii_stage_latency_seconds histogram\n";
+    appendHistogram(out, "stage_latency_seconds", "stage=\"decode\",", counters.decodeLatency);
+    appendHistogram(out, "stage_latency_seconds", "stage=\"resize\",", counters.resizeLatency);
+    appendHistogram(out, "stage_latency_seconds", "stage=\"encode\",", counters.encodeLatency);
+    appendHistogram(out, "stage_latency_seconds", "stage=\"write\",", counters.writeLatency);
+
+    out += "# HELP video2ascii_capture_to_display_seconds Time from a source frame being available to it being written.\n"
+           "# TYPE video2ascii_capture_to_display_seconds histogram\n";
+    appendHistogram(out, "capture_to_display_seconds", "", counters.captureToDisplay);
+
+    out += "# HELP video2ascii_resident_memory_bytes Resident set size.\n"
+           "# TYPE video2ascii_resident_memory_bytes gauge\n"
+           "video2ascii_resident_memory_bytes ";
+    out += std::to_string(residentBytes());
+    out += '\n';
+    return out;
+}
+
+uint64_t residentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    unsigned long long size = 0, resident = 0;
+    if (statm >> size >> resident) {
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+/* --- MetricsExporter --- */
+
+MetricsExporter::MetricsExporter(const PipelineCounters& counters, std::string target)
+    : counters_(counters), target_(std::move(target)) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    std::string host;
+    int port = 0;
+
+    if (!parseAddress(target_, host, port)) {
+        // Fail now rather than silently in the background thread
+        std::ofstream probe(target_ + ".tmp");
+        if (!probe) {
+            std::cerr << "Error: Cannot write metrics to " << target_ << '\n';
+            return false;
+        }
+        running_ = true;
+        thread_ = std::thread(&MetricsExporter::runFile, this);
+        return true;
+    }
+    if (port == 0) {
+        std::cerr << "Error: Invalid port in " << target_ << '\n';
+        return false;
+    }
+
+#ifdef _WIN32
+    std::cerr << "Error: HTTP metrics are not supported on this platform\n";
+    return false;
+#else
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1
+            || (ntohl(addr.sin_addr.s_addr) >> 24) != 127) {
+        std::cerr << "Error: Metrics address must be on a loopback interface: " << target_ << '\n';
+        return false;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    if (fd >= 0) { setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)); }
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || listen(fd, 8) != 0) {
+        std::cerr << "Error: Cannot listen for metrics on " << target_ << '\n';
+        if (fd >= 0) { close(fd); }
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsExporter::runHttp, this, fd);
+    return true;
+#endif
+}
+
+void MetricsExporter::stop() {
+    if (!running_.exchange(false)) { return; }
+    if (thread_.joinable()) { thread_.join(); }
+}
+
+void MetricsExporter::runFile() {
+    const std::string tmp = target_ + ".tmp";
+    auto next = std::chrono::steady_clock::now();
+
+    // Keep going until stopped, then write once more so the file holds final totals
+    for (bool last = false; !last; ) {
+        last = !running_.load();
+        if (last || std::chrono::steady_clock::now() >= next) {
+            {
+                std::ofstream out(tmp, std::ios::trunc);
+                out << formatMetrics(counters_);
+            }
+            std::rename(tmp.c_str(), target_.c_str());
+            next += EXPORT_INTERVAL;
+        }
+        if (!last) { std::this_thread::sleep_for(POLL_INTERVAL); }
+    }
+}
+
+void MetricsExporter::runHttp(int listenFd) {
+#ifndef _WIN32
+    while (running_.load()) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(POLL_INTERVAL.count())) <= 0) { continue; }
+
+        int client = accept(listenFd, nullptr, nullptr);
+        if (client < 0) { continue; }
+
+        // The request itself is irrelevant; every path serves the metrics
+        char request[1024];
+        pollfd cpfd{client, POLLIN, 0};
+        if (poll(&cpfd, 1, 500) > 0) { (void)!read(client, request, sizeof(request)); }
+
+        const std::string body = formatMetrics(counters_);
+        std::string response = "HTTP/1.1 200 OK\r\n"
+                               "Content-Type: text/plain; version=0.0.4\r\n"
+                               "Connection: close\r\n"
+                               "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        response += body;
+
+        const char* data = response.data();
+        size_t left = response.size();
+        while (left > 0) {
+            ssize_t n = send(client, data, left, MSG_NOSIGNAL);
+            if (n <= 0) { break; }
+            data += n;
+            left -= static_cast<size_t>(n);
+        }
+        close(client);
+    }
+    close(listenFd);
+#else
+    (void)listenFd;
+#endif
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "counters.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Prometheus text-format export of PipelineCounters for long-running
+// playback. The target is either a file path, rewritten atomically every
+// interval (suitable for node_exporter's textfile collector), or a
+// "[host]:port" address served over HTTP on a loopback interface.
+class MetricsExporter {
+public:
+    MetricsExporter(const PipelineCounters& counters, std::string target);
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Start the background thread. Returns false (with a message on stderr)
+    // if the target cannot be used.
+    bool start();
+    void stop();
+
+private:
+    void runFile();
+    void runHttp(int listenFd);
+
+    const PipelineCounters& counters_;
+    std::string target_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+// Render the current counters in Prometheus text exposition format
+std::string formatMetrics(const PipelineCounters& counters);
+
+// Resident set size of this process in bytes, or 0 if unknown
+uint64_t residentBytes();
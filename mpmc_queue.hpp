@@ -0,0 +1,148 @@
+#pragma once
+
+#include "waiter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+// Bounded multi-producer, multi-consumer queue (Vyukov's sequence-numbered
+// ring). Each cell carries a sequence number telling producers and consumers
+// whose turn it is, so neither side ever takes a lock. Blocking calls spin
+// then sleep (see Waiter) and the *Async calls suspend a coroutine instead
+// (see WaitFor); after close(), push fails and pop drains.
+template <typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(size_t capacity, int spins = Waiter::DEFAULT_SPINS)
+        : capacity_(roundUpPow2(capacity)), mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]), spins_(spins) {
+        for (size_t i = 0; i < capacity_; i++) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    notEmpty_.notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // Full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& out) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            const size_t seq = cell.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    cell.seq.store(pos + capacity_, std::memory_order_release);
+                    notFull_.notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // Empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool push(const T& value) {
+        bool pushed = false;
+        notFull_.wait([&] { return closed() || (pushed = tryPush(value)); }, spins_);
+        return pushed;
+    }
+
+    bool pop(T& out) {
+        bool popped = false;
+        notEmpty_.wait([&] {
+            return (popped = tryPop(out)) || (closed() && !(popped = tryPop(out)));
+        }, spins_);
+        return popped;
+    }
+
+    // Block for one item, then take up to `max - 1` more without waiting.
+    // Returns 0 only once the queue is closed and drained.
+    size_t popBatch(T* out, size_t max) {
+        if (max == 0 || !pop(out[0])) { return 0; }
+        size_t n = 1;
+        while (n < max && tryPop(out[n])) { n++; }
+        return n;
+    }
+
+    // Coroutine push: yields false once closed
+    auto pushAsync(T value) {
+        return WaitFor(notFull_, [this, value]() -> std::optional<bool> {
+            if (closed()) { return false; }
+            if (tryPush(value)) { return true; }
+            return std::nullopt;
+        });
+    }
+
+    // Coroutine pop: yields std::nullopt once closed and drained
+    auto popAsync() {
+        using Popped = std::optional<std::optional<T>>;
+        return WaitFor(notEmpty_, [this]() -> Popped {
+            T value{};
+            if (tryPop(value)) { return Popped(std::in_place, value); }
+            if (!closed()) { return Popped(); }
+            if (tryPop(value)) { return Popped(std::in_place, value); }
+            return Popped(std::in_place);
+        });
+    }
+
+    size_t size() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        notEmpty_.notify();
+        notFull_.notify();
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) { p <<= 1; }
+        return p;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    const int spins_;
+
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<bool> closed_{false};
+
+    Waiter notEmpty_, notFull_;
+};
@@ -0,0 +1,104 @@
+#include "perf_counters.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/* --- PerfSample --- */
+
+PerfSample& PerfSample::operator+=(const PerfSample& o) {
+    cycles += o.cycles;
+    instructions += o.instructions;
+    cacheMisses += o.cacheMisses;
+    branchMisses += o.branchMisses;
+    return *this;
+}
+
+PerfSample PerfSample::operator-(const PerfSample& o) const {
+    PerfSample d;
+    d.cycles = cycles - o.cycles;
+    d.instructions = instructions - o.instructions;
+    d.cacheMisses = cacheMisses - o.cacheMisses;
+    d.branchMisses = branchMisses - o.branchMisses;
+    return d;
+}
+
+/* --- PerfCounters --- */
+
+#ifdef __linux__
+
+namespace {
+
+int openCounter(uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (groupFd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+}
+
+PerfCounters::PerfCounters() {
+    constexpr uint64_t configs[4] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    for (int i = 0; i < 4; i++) {
+        fds_[i] = openCounter(configs[i], i == 0 ? -1 : fds_[0]);
+        if (fds_[i] < 0) {
+            // All or nothing: a partial group would report misleading ratios
+            for (int j = 0; j < i; j++) { close(fds_[j]); fds_[j] = -1; }
+            return;
+        }
+    }
+
+    groupFd_ = fds_[0];
+    ioctl(groupFd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(groupFd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) { close(fd); }
+    }
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+    if (groupFd_ < 0) { return sample; }
+
+    // Layout for PERF_FORMAT_GROUP: nr, time_enabled, time_running, values[nr]
+    uint64_t buf[3 + 4];
+    if (::read(groupFd_, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) { return sample; }
+
+    const uint64_t enabled = buf[1], running = buf[2];
+    auto scaled = [&](uint64_t v) {
+        if (running == 0 || running >= enabled) { return v; }
+        return static_cast<uint64_t>(static_cast<double>(v) * enabled / running);
+    };
+    sample.cycles = scaled(buf[3]);
+    sample.instructions = scaled(buf[4]);
+    sample.cacheMisses = scaled(buf[5]);
+    sample.branchMisses = scaled(buf[6]);
+    return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() {}
+PerfCounters::~PerfCounters() {}
+PerfSample PerfCounters::read() const { return PerfSample{}; }
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+// Hardware performance counters for the calling thread (cycles, instructions,
+// cache misses, branch misses) via Linux perf_event_open. On other platforms,
+// or when the kernel refuses access (perf_event_paranoid, containers, VMs),
+// available() is false and every read returns zeros.
+
+struct PerfSample {
+    uint64_t cycles         = 0;
+    uint64_t instructions   = 0;
+    uint64_t cacheMisses    = 0;
+    uint64_t branchMisses   = 0;
+
+    PerfSample& operator+=(const PerfSample& o);
+    PerfSample operator-(const PerfSample& o) const;
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return groupFd_ >= 0; }
+
+    // Running totals since construction, scaled for multiplexing
+    PerfSample read() const;
+
+private:
+    int groupFd_ = -1;
+    int fds_[4] = {-1, -1, -1, -1};
+};
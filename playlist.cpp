@@ -0,0 +1,27 @@
+#include "playlist.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+/* --- Playlists --- */
+
+bool readPlaylist(const std::string& path, std::vector<std::string>& items) {
+    std::ifstream in(path);
+    if (!in) { return false; }
+
+    const std::filesystem::path base = std::filesystem::path(path).parent_path();
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') { continue; }
+        const size_t last = line.find_last_not_of(" \t\r");
+        std::string item = line.substr(first, last - first + 1);
+
+        // URLs and absolute paths are taken as they are
+        if (item.find("://") == std::string::npos && std::filesystem::path(item).is_relative()) {
+            item = (base / item).string();
+        }
+        items.push_back(std::move(item));
+    }
+    return true;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Playlists for --playlist: a text file naming one input per line, in
+// playback order. Blank lines and lines starting with '#' are skipped, so
+// a plain M3U file works. Relative paths are relative to the playlist.
+
+// Inputs listed in `path`; false if it cannot be read
+bool readPlaylist(const std::string& path, std::vector<std::string>& items);
@@ -0,0 +1,102 @@
+#include "sink.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char CLEAR_SCREEN[] = "\033[2J\033[H";
+
+}
+
+/* --- TerminalSink --- */
+
+void TerminalSink::begin() {
+#ifdef _WIN32
+    system("cls");
+#else
+    std::cout << CLEAR_SCREEN << std::flush;
+#endif
+}
+
+void TerminalSink::write(const std::string_view* parts, size_t count) {
+#ifdef _WIN32
+    for (size_t i = 0; i < count; i++) { std::cout << parts[i]; }
+    std::cout << std::flush;
+#else
+    constexpr size_t MAX_PARTS = 64;
+    iovec iov[MAX_PARTS];
+    for (size_t base = 0; base < count; base += MAX_PARTS) {
+        size_t n = 0;
+        for (size_t i = base; i < count && i < base + MAX_PARTS; i++) {
+            if (parts[i].empty()) { continue; }
+            iov[n].iov_base = const_cast<char*>(parts[i].data());
+            iov[n].iov_len = parts[i].size();
+            n++;
+        }
+
+        // Resume after short writes until every part is out
+        iovec* next = iov;
+        while (n > 0) {
+            const ssize_t written = ::writev(STDOUT_FILENO, next, static_cast<int>(n));
+            if (written < 0) {
+                if (errno == EINTR) { continue; }
+                return;
+            }
+            size_t left = static_cast<size_t>(written);
+            while (n > 0 && left >= next->iov_len) {
+                left -= next->iov_len;
+                next++;
+                n--;
+            }
+            if (n > 0) {
+                next->iov_base = static_cast<char*>(next->iov_base) + left;
+                next->iov_len -= left;
+            }
+        }
+    }
+#endif
+}
+
+bool terminalSize(int& rows, int& cols) {
+#ifdef _WIN32
+    return false;
+#else
+    winsize ws{};
+    if (!isatty(STDOUT_FILENO) || ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0) {
+        return false;
+    }
+    rows = ws.ws_row;
+    cols = ws.ws_col;
+    return true;
+#endif
+}
+
+/* --- FileSink --- */
+
+FileSink::~FileSink() {
+    if (file_) { std::fclose(file_); }
+}
+
+bool FileSink::open(const std::string& path) {
+    file_ = std::fopen(path.c_str(), "wb");
+    return file_ != nullptr;
+}
+
+void FileSink::begin() {
+    std::fputs(CLEAR_SCREEN, file_);
+}
+
+void FileSink::write(const std::string_view* parts, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        std::fwrite(parts[i].data(), 1, parts[i].size(), file_);
+    }
+    std::fflush(file_);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Destinations for presented frames. The presentation task writes every
+// sink in turn, so adding one costs no thread. A sink receives the frame
+// stream exactly as the terminal does (escape sequences included).
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    // Called once before the first frame
+    virtual void begin() = 0;
+    // One whole frame, gathered from `count` parts
+    virtual void write(const std::string_view* parts, size_t count) = 0;
+};
+
+// Standard output. Frames go out with a single writev() where available,
+// so row bands reach the terminal without being joined first.
+class TerminalSink : public Sink {
+public:
+    void begin() override;
+    void write(const std::string_view* parts, size_t count) override;
+};
+
+// Rows and columns of the terminal on standard output; false if standard
+// output is not a terminal
+bool terminalSize(int& rows, int& cols);
+
+// A file that replays the playback with `cat`
+class FileSink : public Sink {
+public:
+    FileSink() = default;
+    ~FileSink() override;
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool open(const std::string& path);
+
+    void begin() override;
+    void write(const std::string_view* parts, size_t count) override;
+
+private:
+    std::FILE* file_ = nullptr;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "waiter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// Bounded single-producer, single-consumer ring. Head and tail live on their
+// own cache lines and each side caches the other's index, so a handoff costs
+// one shared cache-line transfer in the common case. Blocking calls spin then
+// sleep (see Waiter) and the *Async calls suspend a coroutine instead (see
+// WaitFor); after close(), push fails and pop drains what is left.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity, int spins = Waiter::DEFAULT_SPINS)
+        : slots_(roundUpPow2(capacity)), mask_(slots_.size() - 1), spins_(spins) {}
+
+    bool tryPush(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ > mask_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ > mask_) { return false; }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        notEmpty_.notify();
+        return true;
+    }
+
+    bool push(const T& value) {
+        bool pushed = false;
+        notFull_.wait([&] { return closed() || (pushed = tryPush(value)); }, spins_);
+        return pushed;
+    }
+
+    bool tryPop(T& out) {
+        return popBatch(&out, 1, false) == 1;
+    }
+
+    bool pop(T& out) {
+        return popBatch(&out, 1, true) == 1;
+    }
+
+    // Pop up to `max` items. When blocking, waits for at least one; returns 0
+    // only once the queue is closed and drained.
+    size_t popBatch(T* out, size_t max, bool block = true) {
+        size_t n = 0;
+        auto take = [&] {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (cachedTail_ == head) { cachedTail_ = tail_.load(std::memory_order_acquire); }
+            const size_t available = cachedTail_ - head;
+            n = available < max ? available : max;
+            for (size_t i = 0; i < n; i++) { out[i] = slots_[(head + i) & mask_]; }
+            if (n > 0) {
+                head_.store(head + n, std::memory_order_release);
+                notFull_.notify();
+            }
+            return n > 0;
+        };
+
+        if (!block) {
+            take();
+            return n;
+        }
+        // Re-check after seeing closed so items pushed just before close() are not lost
+        notEmpty_.wait([&] { return take() || (closed() && !take()); }, spins_);
+        return n;
+    }
+
+    // Coroutine push: yields false once closed
+    auto pushAsync(T value) {
+        return WaitFor(notFull_, [this, value]() -> std::optional<bool> {
+            if (closed()) { return false; }
+            if (tryPush(value)) { return true; }
+            return std::nullopt;
+        });
+    }
+
+    // Coroutine popBatch: yields the number popped, 0 once closed and drained
+    auto popBatchAsync(T* out, size_t max) {
+        return WaitFor(notEmpty_, [this, out, max]() -> std::optional<size_t> {
+            if (size_t n = popBatch(out, max, false)) { return n; }
+            if (closed()) { return popBatch(out, max, false); }
+            return std::nullopt;
+        });
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        notEmpty_.notify();
+        notFull_.notify();
+    }
+
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) { p <<= 1; }
+        return p;
+    }
+
+    std::vector<T> slots_;
+    const size_t mask_;
+    const int spins_;
+
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;                     // Consumer's view of tail_
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;                     // Producer's view of head_
+    alignas(64) std::atomic<bool> closed_{false};
+
+    Waiter notEmpty_, notFull_;
+};
@@ -0,0 +1,142 @@
+#include "stats.hpp"
+
+#include <cstdio>
+
+/* --- PipelineStats --- */
+
+void PipelineStats::merge(const PipelineStats& other) {
+    frames += other.frames;
+    framesDecoded += other.framesDecoded;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        stages[i].seconds += other.stages[i].seconds;
+        stages[i].counters += other.stages[i].counters;
+        stages[i].allocs += other.stages[i].allocs;
+        stages[i].steadyAllocs += other.stages[i].steadyAllocs;
+    }
+    countersAvailable = countersAvailable && other.countersAvailable;
+    allocsAvailable = allocsAvailable && other.allocsAvailable;
+}
+
+/* --- StageProbe --- */
+
+namespace {
+
+// Counters follow the thread, and a coroutine may resume on any pool thread
+const PerfCounters& threadCounters() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+}
+
+StageProbe::StageProbe(PipelineStats* stats) : stats_(stats) {
+    if (!stats_) { return; }
+    stats_->countersAvailable = threadCounters().available();
+    stats_->allocsAvailable = allocStatsEnabled();
+}
+
+void StageProbe::begin() {
+    if (!stats_) { return; }
+    lastSample_ = threadCounters().read();
+    lastAllocs_ = threadAllocs();
+    lastTime_ = Clock::now();
+}
+
+void StageProbe::lap(Stage stage) {
+    if (!stats_) { return; }
+    const auto now = Clock::now();
+    const PerfSample sample = threadCounters().read();
+    const AllocSample allocs = threadAllocs();
+
+    StageStats& s = (*stats_)[stage];
+    s.seconds += std::chrono::duration<double>(now - lastTime_).count();
+    s.counters += sample - lastSample_;
+    s.allocs += allocs - lastAllocs_;
+    if (++laps_[static_cast<int>(stage)] > ALLOC_WARMUP_FRAMES) {
+        s.steadyAllocs += allocs - lastAllocs_;
+    }
+
+    lastTime_ = now;
+    lastSample_ = sample;
+    lastAllocs_ = allocs;
+}
+
+/* --- Function Definitions --- */
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Decode: return "decode";
+        case Stage::Resize: return "resize";
+        case Stage::Encode: return "encode";
+        case Stage::Write:  return "write";
+    }
+    return "unknown";
+}
+
+void printStats(const PipelineStats& stats, std::ostream& os) {
+    const double frames = stats.frames > 0 ? static_cast<double>(stats.frames) : 1.0;
+    char line[160];
+
+    os << "\n--- Stats (" << stats.frames << " frames) ---\n";
+    std::snprintf(line, sizeof(line), "time to first frame: %.1f ms\n", stats.timeToFirstFrameMs);
+    os << line;
+    std::snprintf(line, sizeof(line), "capture to display: %.1f ms mean, %.1f ms max\n",
+                  stats.captureToDisplayMs, stats.captureToDisplayMaxMs);
+    os << line;
+
+    // Frames per second of decoder busy time: what decoding alone sustains,
+    // independent of how fast the rest of the pipeline drains it
+    const double decodeSeconds = stats[Stage::Decode].seconds;
+    if (stats.framesDecoded > 0 && decodeSeconds > 0) {
+        std::snprintf(line, sizeof(line), "decode: %.1f fps over %llu frames (%s)\n",
+                      stats.framesDecoded / decodeSeconds,
+                      static_cast<unsigned long long>(stats.framesDecoded),
+                      stats.decoder.empty() ? "unknown backend" : stats.decoder.c_str());
+        os << line;
+    }
+    if (!stats.loop.empty()) {
+        os << "loop: " << stats.loop << '\n';
+    }
+    os << '\n';
+    std::snprintf(line, sizeof(line), "%-8s %10s %14s %14s %6s %14s %14s\n", "stage", "ms/frame",
+                  "cycles/frame", "instrs/frame", "IPC", "cache-miss/f", "branch-miss/f");
+    os << line;
+
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const auto stage = static_cast<Stage>(i);
+        const StageStats& s = stats[stage];
+        const double ms = s.seconds * 1000.0 / frames;
+
+        if (!stats.countersAvailable) {
+            std::snprintf(line, sizeof(line), "%-8s %10.3f %14s %14s %6s %14s %14s\n",
+                          stageName(stage), ms, "-", "-", "-", "-", "-");
+        } else {
+            const PerfSample& c = s.counters;
+            const double ipc = c.cycles > 0 ? static_cast<double>(c.instructions) / c.cycles : 0.0;
+            std::snprintf(line, sizeof(line), "%-8s %10.3f %14.0f %14.0f %6.2f %14.0f %14.0f\n",
+                          stageName(stage), ms, c.cycles / frames, c.instructions / frames, ipc,
+                          c.cacheMisses / frames, c.branchMisses / frames);
+        }
+        os << line;
+    }
+
+    if (!stats.countersAvailable) {
+        os << "(hardware counters unavailable)\n";
+    }
+
+    if (stats.allocsAvailable) {
+        // Steady: allocations after each task's warmup frames, which should
+        // be none
+        std::snprintf(line, sizeof(line), "\n%-8s %14s %14s %14s\n", "stage", "allocs/frame",
+                      "bytes/frame", "steady allocs");
+        os << line;
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            const auto stage = static_cast<Stage>(i);
+            const AllocSample& a = stats[stage].allocs;
+            std::snprintf(line, sizeof(line), "%-8s %14.2f %14.0f %14llu\n", stageName(stage),
+                          a.count / frames, a.bytes / frames,
+                          static_cast<unsigned long long>(stats[stage].steadyAllocs.count));
+            os << line;
+        }
+    }
+}
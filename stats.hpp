@@ -0,0 +1,81 @@
+#pragma once
+
+#include "alloc_stats.hpp"
+#include "perf_counters.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Per-stage timing, hardware counter and allocation accounting for --stats.
+
+/* --- Custom Types --- */
+
+enum class Stage : uint8_t {
+    Decode,
+    Resize,
+    Encode,
+    Write                               // Gathering a frame and writing it to the sinks
+};
+
+constexpr int STAGE_COUNT = 4;
+
+// Laps of a stage each task runs before its allocations count as steady
+// state: buffers grow to the grid on first use
+constexpr uint64_t ALLOC_WARMUP_FRAMES = 8;
+
+struct StageStats {
+    double seconds = 0;
+    PerfSample counters;
+    AllocSample allocs;
+    AllocSample steadyAllocs;           // After each task's warmup
+};
+
+struct PipelineStats {
+    uint64_t frames = 0;
+    uint64_t framesDecoded = 0;         // Read from the source, including ones dropped later
+    std::string decoder;                // Backend and thread count, as reported
+    std::string loop;                   // How --loop plays later passes, and why
+    double timeToFirstFrameMs = 0;      // Launch until the first frame is written
+    double captureToDisplayMs = 0;      // Mean source-available-to-written latency
+    double captureToDisplayMaxMs = 0;
+    StageStats stages[STAGE_COUNT];
+    bool countersAvailable = false;
+    bool allocsAvailable = false;
+
+    // Fold in stages measured on another thread
+    void merge(const PipelineStats& other);
+
+    StageStats& operator[](Stage stage) { return stages[static_cast<int>(stage)]; }
+    const StageStats& operator[](Stage stage) const { return stages[static_cast<int>(stage)]; }
+};
+
+// Charges wall time, counters and allocations between successive marks to pipeline stages.
+// Constructed with a null PipelineStats it does nothing, so the hot loop can
+// call it unconditionally. Counters are read on the calling thread, so a
+// coroutine must not suspend between a mark and the next lap.
+class StageProbe {
+public:
+    explicit StageProbe(PipelineStats* stats);
+
+    // Mark the start of a frame
+    void begin();
+
+    // Charge everything since the previous mark to `stage`
+    void lap(Stage stage);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PipelineStats* stats_;
+    Clock::time_point lastTime_;
+    PerfSample lastSample_;
+    AllocSample lastAllocs_;
+    uint64_t laps_[STAGE_COUNT] = {};
+};
+
+/* --- Function Prototypes --- */
+
+const char* stageName(Stage stage);
+void printStats(const PipelineStats& stats, std::ostream& os);
@@ -1,87 +1,282 @@
+#include "ascii.hpp"
+#include "cell_cache.hpp"
+#include "counters.hpp"
+#include "decode_scale.hpp"
+#include "executor.hpp"
+#include "frame_pool.hpp"
+#include "frame_ring.hpp"
+#include "grid_target.hpp"
+#include "hud.hpp"
+#include "image_sequence.hpp"
+#include "keyboard.hpp"
+#include "letterbox.hpp"
+#include "mailbox.hpp"
+#include "metrics.hpp"
+#include "mpmc_queue.hpp"
+#include "playlist.hpp"
+#include "sink.hpp"
+#include "spsc_queue.hpp"
+#include "stats.hpp"
+#include "viewport.hpp"
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
+#include <memory>
+#include <mutex>
 #include <opencv2/opencv.hpp>
 #include <opencv2/videoio.hpp>
 #include <iostream>
-#include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <optional>
 #include <thread>
+#include <algorithm>
 #include <chrono>
 
 /* --- Global Constants --- */
 
-constexpr char asciiChars[] = {'@', '%', '#', '*', '+', '=', '-', ':', '.', ' '};
-constexpr int asciiLen = sizeof(asciiChars);
-
 constexpr int DEFAULT_TARGET_HEIGHT = 60;
 constexpr int DEFAULT_TARGET_WIDTH  = 0;     // Auto detect from aspect ratio
 constexpr int MIN_HEIGHT            = 20;
 constexpr int MIN_WIDTH             = 40;
-constexpr int MAX_HEIGHT            = 120;
-constexpr int MAX_WIDTH             = 200;
+constexpr int MAX_HEIGHT            = 2048;    // LED walls driven through a terminal
+constexpr int MAX_WIDTH             = 4096;
 
 constexpr int DEFAULT_FRAMERATE = 30;
 constexpr int MIN_FRAMERATE     = 1;
 constexpr int MAX_FRAMERATE     = 120;
-constexpr int MAX_FRAME_COUNT   = 100000;
 
-enum class ColorMode : uint8_t {
-    None,
-    ANSI,
-    Full
-};
+// Converted frames buffered ahead of playback
+constexpr size_t FRAME_QUEUE_DEPTH = 32;
+// ... unless that many frames of the grid would take more than this; very
+// large grids buffer fewer frames, but never fewer than the minimum
+constexpr size_t FRAME_QUEUE_BYTES     = size_t(256) << 20;
+constexpr size_t MIN_FRAME_QUEUE_DEPTH = 4;
+// Decoded frames waiting for conversion
+constexpr size_t DECODE_QUEUE_DEPTH = 4;
+// Decoded frames the dispatcher moves to the workers at once
+constexpr size_t DISPATCH_BATCH = 4;
+// Live sources: converted frames buffered ahead of playback, and capture
+// buffers (one being captured, one waiting, one being converted, one spare)
+constexpr size_t LIVE_QUEUE_DEPTH = 2;
+constexpr size_t LIVE_POOL_SIZE   = 4;
 
-namespace Color {
-    constexpr const char* BLACK = "\x1b[30m";
-    constexpr const char* RED   = "\x1b[31m";
-    constexpr const char* GREEN = "\x1b[32m";
-    constexpr const char* BLUE  = "\x1b[34m";
-    constexpr const char* WHITE = "\x1b[37m";
+constexpr int MIN_THREADS = 1;
+constexpr int MAX_THREADS = 16;
+// Decoder threads; 0 lets the backend choose
+constexpr int MIN_DECODE_THREADS = 0;
 
-    constexpr const char* BRIGHT_BLACK = "\x1b[90m";
-    constexpr const char* BRIGHT_RED   = "\x1b[91m";
-    constexpr const char* BRIGHT_GREEN = "\x1b[92m";
-    constexpr const char* BRIGHT_BLUE  = "\x1b[94m";
-    constexpr const char* BRIGHT_WHITE = "\x1b[97m";
+// Black bar detection: frames sampled from the start of the source
+constexpr double CROP_SAMPLE_SECONDS = 3.0;
+constexpr int CROP_SAMPLES = 8;
 
-    constexpr const char* TRUECOLOR = "\x1b[38;2;";
-    constexpr const char* RESET = "\x1b[0m";
+// --interactive: how often the keyboard is read, and keys handled per read
+constexpr int KEY_POLL_MS = 20;
+constexpr size_t MAX_KEYS = 16;
 
-    constexpr int DARK_THRESHOLD = 30;
-    constexpr int GRAYSCALE_VARIANCE = 20;
-    constexpr int VERY_BRIGHT = 200;
-    constexpr int BRIGHT = 120;
-    constexpr int MEDIUM_BRIGHT = 128;
-}
+constexpr char CURSOR_HOME[] = "\x1b[H";
+constexpr char CLEAR_AND_HOME[] = "\x1b[2J\x1b[H";
+
+// How often a pending terminal resize is looked for
+constexpr int RESIZE_POLL_MS = 50;
+
+// URL schemes of network streams, which are always played live
+constexpr const char* LIVE_SCHEMES[] = {
+    "rtsp://", "rtsps://", "rtmp://", "rtp://", "udp://", "tcp://", "srt://"
+};
+
+// --backend names
+constexpr std::pair<const char*, cv::VideoCaptureAPIs> BACKENDS[] = {
+    {"any", cv::CAP_ANY}, {"ffmpeg", cv::CAP_FFMPEG}, {"gstreamer", cv::CAP_GSTREAMER},
+    {"v4l2", cv::CAP_V4L2}, {"msmf", cv::CAP_MSMF}, {"dshow", cv::CAP_DSHOW},
+    {"avfoundation", cv::CAP_AVFOUNDATION}
+};
+
+// --decode-opt keys that are generic capture properties, passed to open();
+// other keys go to the FFmpeg backend
+constexpr std::pair<const char*, int> CAPTURE_PROPERTIES[] = {
+    {"hw_acceleration", cv::CAP_PROP_HW_ACCELERATION}, {"hw_device", cv::CAP_PROP_HW_DEVICE},
+    {"open_timeout_msec", cv::CAP_PROP_OPEN_TIMEOUT_MSEC},
+    {"read_timeout_msec", cv::CAP_PROP_READ_TIMEOUT_MSEC}
+};
+
+// Set by SIGINT/SIGTERM in live and interactive mode, and by the quit key;
+// playback stops at its next frame
+volatile std::sig_atomic_t stopRequested = 0;
+// Set by SIGWINCH; the grid is re-targeted at the next poll
+volatile std::sig_atomic_t terminalResized = 0;
+// Held by openCapture() for the whole time OPENCV_FFMPEG_CAPTURE_OPTIONS is changed
+std::mutex captureOpenMutex;
 
 /* --- Custom Types --- */
 
+// How conversion work is spread across threads
+enum class Parallelism : uint8_t {
+    Frames,     // Whole frames in parallel: throughput, one frame of latency per worker
+    Rows        // Each frame's rows in parallel: lowest per-frame latency
+};
+
+// Where frames come from
+enum class SourceKind : uint8_t {
+    File,       // Played at its own framerate; looped and paced like a camera with --live
+    Device,     // Capture device: index or /dev/videoN
+    Stream,     // Network stream URL
+    Images      // Directory or wildcard pattern of still images
+};
+
 struct Options {
-    const char* videoPath;
+    const char* videoPath   = nullptr;
+    std::string playlist;               // --playlist file; empty = play videoPath
+    int loops               = 1;        // Passes to play (--loop); 0 = forever
+    SourceKind source       = SourceKind::File;
+    bool live               = false;    // Newest frame first, drop stale ones
+    bool fullDecode         = false;    // Never decode at reduced resolution
+    bool autoCrop           = true;     // Crop black bars
+    cv::Rect roi;                       // --roi in source pixels; empty = none
+    bool interactive        = false;    // Zoom and pan with the keyboard
     ColorMode colorMode     = ColorMode::None;
     int targetHeight        = DEFAULT_TARGET_HEIGHT;
     int targetWidth         = DEFAULT_TARGET_WIDTH;
     int framerate           = -1;
+    int threads             = 0;     // Conversion workers; 0 = auto
+    int decodeThreads       = -1;    // -1 = backend default
+    cv::VideoCaptureAPIs backend = cv::CAP_ANY;
+    std::vector<std::pair<std::string, std::string>> decodeOptions;   // --decode-opt key, value
+    Parallelism parallelism = Parallelism::Frames;
+    ResizeMethod resizeMethod = ResizeMethod::Auto;
+    bool stats              = false;
+    bool hud                = false;
+    std::string metricsTarget;
+    std::string teePath;
+};
+
+// An opened input
+struct Source {
+    cv::VideoCapture cap;
+    std::vector<int> params;            // Capture properties given to open()
+    std::string ffmpegOptions;          // For OPENCV_FFMPEG_CAPTURE_OPTIONS
+    std::vector<std::string> images;    // Image sequences, in playback order
+    int imreadFlags = cv::IMREAD_COLOR;
+    cv::Size size;                      // Of the (first) frame, as decoded
+    cv::Rect crop;                      // Part of each frame that is shown
+    double fps = 0;                     // 0 if the source does not say
+    int decodeScale = 1;                // Frames decode at 1/decodeScale size
+    size_t firstImage = 0;              // Image sequences: where the next pass starts
+};
+
+// A playlist entry after the first, opened while the one before it plays
+struct PlaylistItem {
+    Options opts;                       // The shared options, for this entry
+    Source source;
+    std::optional<Viewport> view;
+};
+
+// A decoded frame and its position in the stream
+struct FrameTask {
+    uint64_t seq;
+    FrameBuffers* buffers;
+    const std::string* image = nullptr; // Image sequences: decoded by the worker
+};
+
+// Presentation schedule of a file: each frame owns a slot one period long.
+// Slots follow absolute deadlines from the first frame, so oversleeping one
+// frame shortens the next wait instead of delaying every frame after it.
+struct FramePacer {
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point slot;             // When the current frame's slot opens
+
+    // The current slot ended before `now`, so its frame is no longer worth showing
+    bool missed(Clock::time_point now, Clock::duration period) const {
+        return now > slot + period;
+    }
+
+    // Written more than half a slot after it opened
+    bool late(Clock::time_point written, Clock::duration period) const {
+        return written > slot + period / 2;
+    }
+
+    // Move on to the next slot and return when it opens
+    Clock::time_point advance(Clock::duration period) {
+        slot += period;
+        return slot;
+    }
 };
 
 /* --- Function Prototypes --- */
 
 int getOptions(Options &opts, int argc, char** argv);
-void getTargetDimensions(const cv::VideoCapture& cap, Options& opts);
-double getDelayMs(const cv::VideoCapture& cap, const Options& opts);
-void loadFrames(cv::VideoCapture& cap, std::vector<std::string>& asciiFrames,
-        const Options& opts, int height, int width);
-void animateAscii(const std::vector<std::string>& asciiFrames, double delayMs);
-inline char brightnessToAscii(int brightness);
-inline const char* rgbToAnsiColor(int r, int g, int b, int brightness);
-inline std::string rgbToTrueColor(int r, int g, int b, int brightness);
+void requestStop(int);
+void noteResize(int);
+bool openSource(Source& source, Options& opts);
+bool captureParams(const Options& opts, std::vector<int>& params, std::string& ffmpegOptions);
+bool openCapture(cv::VideoCapture& cap, const std::string& path, int index, int backend,
+        const std::vector<int>& params, const std::string& ffmpegOptions);
+bool detectCrop(Source& source, const Options& opts);
+bool reduceDecode(Source& source, const Options& opts);
+std::string withLowres(const std::string& options, int scale);
+bool rewindSource(Source& source, const Options& opts, size_t frame);
+std::unique_ptr<CellCache> loopCache(const Source& source, const Options& opts,
+        const std::vector<std::string>& playlist, cv::Size grid, std::string& strategy);
+bool parseRoi(const char* text, cv::Rect& roi);
+cv::Mat shownPart(const cv::Mat& frame, const Source& source, const Viewport& view);
+void getTargetDimensions(cv::Size sourceSize, Options& opts);
+cv::Size fitGrid(cv::Size grid, int rows, int cols);
+double getDelayMs(double sourceFps, const Options& opts);
+Task openNextItem(const std::vector<std::string>& playlist, size_t& index,
+        const Options& opts, cv::Size grid, std::unique_ptr<PlaylistItem>& item);
+Task loadPlaylist(Executor& executor, Source& source, const Viewport& view,
+        FrameRing& frames, const Options& opts, const std::vector<std::string>& playlist,
+        cv::Size requested, const GridTarget& grid, CellCache* cache, PipelineStats& stats,
+        PipelineCounters& counters);
+Task loadFrames(Executor& executor, Source& source, const Viewport& view, FrameRing& frames,
+        const Options& opts, const GridTarget& grid, CellCache* cache, uint64_t& seq,
+        PipelineStats& stats, PipelineCounters& counters);
+Task decodeFrames(cv::VideoCapture& cap, FramePool& pool,
+        SpscQueue<FrameTask>& decoded, uint64_t& seq, const Options& opts,
+        PipelineStats& stats, PipelineCounters& counters);
+Task queueImages(const std::vector<std::string>& images, size_t first, FramePool& pool,
+        SpscQueue<FrameTask>& decoded, uint64_t& seq, PipelineCounters& counters);
+Task convertFrames(MpmcQueue<FrameTask>& work, FramePool& pool, FrameRing& frames,
+        const Options& opts, const Source& source, const Viewport& view,
+        const GridTarget& grid, CellCache* cache, PipelineStats& stats,
+        PipelineCounters& counters);
+Task replayCells(const CellCache& cache, size_t count, std::atomic<size_t>& next,
+        uint64_t base, FrameRing& frames, const Options& opts, const GridTarget& grid,
+        std::chrono::steady_clock::duration period, uint32_t generation,
+        PipelineStats& stats, PipelineCounters& counters);
+Task loadLiveFrames(Executor& executor, Source& source, const Viewport& view,
+        FrameRing& frames, const Options& opts, double delayMs, const GridTarget& grid,
+        PipelineStats& stats, PipelineCounters& counters);
+Task captureFrames(Executor& executor, cv::VideoCapture& cap, FramePool& pool,
+        Mailbox<FrameBuffers>& latest, const Options& opts, double delayMs,
+        PipelineStats& stats, PipelineCounters& counters);
+Task convertLatest(Mailbox<FrameBuffers>& latest, FramePool& pool, FrameRing& frames,
+        const Options& opts, const Source& source, const Viewport& view,
+        const GridTarget& grid, PipelineStats& stats, PipelineCounters& counters);
+Task steerView(Executor& executor, Keyboard& keyboard, Viewport& view,
+        const std::atomic<bool>& done);
+Task followTerminal(Executor& executor, GridTarget& grid, cv::Size requested,
+        const std::atomic<bool>& done);
+int workerCount(const Options& opts);
+int frameWorkers(const Options& opts);
+Task animateAscii(Executor& executor, FrameRing& frames, const GridTarget& grid,
+        bool live, const std::vector<Sink*>& sinks, PipelineCounters& counters, Hud* hud,
+        PipelineStats& stats, PipelineStats* writeStats,
+        std::chrono::steady_clock::time_point launchTime);
+std::chrono::steady_clock::duration framePeriod(const Source& source, const Options& opts);
 void printHelp();
-void clearScreen();
 
 /* --- Main --- */
 
 int main(int argc, char** argv) {
+    const auto launchTime = std::chrono::steady_clock::now();
+
     if (argc < 2) {
         std::cerr << "Usage: ASCIIAnimator <video_path> [options]\n";
         return 1;
@@ -97,24 +292,164 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    cv::VideoCapture cap(opts.videoPath);
-    if (!cap.isOpened()) {
-        std::cerr << "Error: Could not open video\n";
+    // A playlist starts like a single input, with its first entry
+    std::vector<std::string> playlist;
+    if (!opts.playlist.empty()) {
+        if (!readPlaylist(opts.playlist, playlist)) {
+            std::cerr << "Error: Could not read " << opts.playlist << '\n';
+            return 1;
+        }
+        if (playlist.empty()) {
+            std::cerr << "Error: No entries in " << opts.playlist << '\n';
+            return 1;
+        }
+        opts.videoPath = playlist.front().c_str();
+    }
+
+    Source source;
+    if (!openSource(source, opts)) {
+        return 1;
+    }
+    if (!playlist.empty() && opts.live) {
+        std::cerr << "Error: Playlist entries must be video files or image sequences\n";
+        return 1;
+    }
+    if (opts.loops != 1 && opts.live) {
+        std::cerr << "Error: --loop needs a file, image sequence or playlist "
+                  << "(--live loops a file already)\n";
         return 1;
     }
 
-    getTargetDimensions(cap, opts);
+    if (!opts.roi.empty()) {
+        const cv::Rect frame(0, 0, source.size.width, source.size.height);
+        if ((opts.roi & frame) != opts.roi) {
+            std::cerr << "Error: --roi is outside the " << source.size.width << 'x'
+                      << source.size.height << " frame\n";
+            return 1;
+        }
+        source.crop = opts.roi;
+    } else if (opts.autoCrop && !detectCrop(source, opts)) {
+        std::cerr << "Error: Could not rewind video\n";
+        return 1;
+    }
+    getTargetDimensions(source.crop.size(), opts);
+    if (!opts.fullDecode && !reduceDecode(source, opts)) {
+        std::cerr << "Error: Could not reopen video\n";
+        return 1;
+    }
+    double delayMs = getDelayMs(source.fps, opts);
+    Viewport view(source.crop, cv::Size(opts.targetWidth, opts.targetHeight));
+
+    // Decoding was reduced for the grid asked for, the largest it can be. On
+    // a terminal the grid shrinks to fit, and follows the terminal's size.
+    const cv::Size requested(opts.targetWidth, opts.targetHeight);
+    int rows = 0, cols = 0;
+    const bool onTerminal = terminalSize(rows, cols);
+    if (onTerminal) {
+        const cv::Size fitted = fitGrid(requested, rows, cols);
+        opts.targetWidth = fitted.width;
+        opts.targetHeight = fitted.height;
+    }
+    GridTarget grid(cv::Size(opts.targetWidth, opts.targetHeight));
+
+    PipelineStats stats, writeStats;
+    if (source.images.empty()) {
+        const int decodeThreads = static_cast<int>(source.cap.get(cv::CAP_PROP_N_THREADS));
+        stats.decoder = source.cap.getBackendName();
+        if (decodeThreads > 0) { stats.decoder += ", " + std::to_string(decodeThreads) + " threads"; }
+    } else {
+        stats.decoder = "imread";
+    }
+    if (source.decodeScale > 1) {
+        stats.decoder += ", 1/" + std::to_string(source.decodeScale) + " scale";
+    }
+    std::unique_ptr<CellCache> cache = loopCache(source, opts, playlist, grid.load().size,
+        stats.loop);
+    PipelineCounters counters;
+    MetricsExporter metrics(counters, opts.metricsTarget);
+    if (!opts.metricsTarget.empty() && !metrics.start()) {
+        return 1;
+    }
+
+    TerminalSink terminal;
+    FileSink tee;
+    std::vector<Sink*> sinks = {&terminal};
+    if (!opts.teePath.empty()) {
+        if (!tee.open(opts.teePath)) {
+            std::cerr << "Error: Could not open " << opts.teePath << '\n';
+            return 1;
+        }
+        sinks.push_back(&tee);
+    }
+
+    // Live sources want the newest frame on screen soonest, which is row
+    // mode. They and --loop may never end by themselves, so Ctrl-C ends
+    // playback cleanly. So it does with the keyboard taken over, which must
+    // be given back.
+    Keyboard keyboard;
+    if (opts.interactive && !keyboard.open()) {
+        std::cerr << "Error: --interactive needs a terminal on standard input\n";
+        return 1;
+    }
+    if (opts.live) { opts.parallelism = Parallelism::Rows; }
+    if (opts.live || opts.interactive || opts.loops != 1) {
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+    }
+#ifdef SIGWINCH
+    if (onTerminal) { std::signal(SIGWINCH, noteResize); }
+#endif
 
-    std::vector<std::string> asciiFrames;
-    auto frameCount = cap.get(cv::CAP_PROP_FRAME_COUNT);
-    if (frameCount > 0 && frameCount < MAX_FRAME_COUNT) {
-        asciiFrames.reserve(static_cast<size_t>(frameCount));
+    // In row mode each frame is encoded as one band per thread, and OpenCV's
+    // own pool splits the resize by rows
+    int bands = 1;
+    if (opts.parallelism == Parallelism::Rows) {
+        bands = std::min(workerCount(opts), opts.targetHeight);
+        cv::setNumThreads(bands);
     }
 
-    double delayMs = getDelayMs(cap, opts);
+    // Conversion runs alongside playback, which starts with the first frame.
+    // The decoder and the presenter may block in I/O, so they get a thread
+    // each on top of the conversion workers, as does opening the next
+    // playlist entry.
+    // Sized for the requested grid, the largest the terminal can make it
+    const size_t frameBytes = maxFrameBytes(opts.colorMode, requested.width, requested.height);
+    const size_t depth = opts.live ? LIVE_QUEUE_DEPTH
+        : std::clamp(FRAME_QUEUE_BYTES / frameBytes, MIN_FRAME_QUEUE_DEPTH, FRAME_QUEUE_DEPTH);
+    FrameRing frames(depth, bands,
+        maxFrameBytes(opts.colorMode, opts.targetWidth, (opts.targetHeight + bands - 1) / bands));
+    // The status line sits on the row below the frame
+    Hud hud(opts.targetHeight + 1, opts.targetWidth, opts.colorMode);
+    {
+        Executor executor(frameWorkers(opts) + 2 + (playlist.size() > 1 ? 1 : 0));
+        TaskGroup pipeline, controls;
+        std::atomic<bool> done{false};
+        if (opts.live) {
+            executor.spawn(loadLiveFrames(executor, source, view, frames, opts, delayMs,
+                grid, stats, counters), pipeline);
+        } else {
+            executor.spawn(loadPlaylist(executor, source, view, frames, opts, playlist,
+                requested, grid, cache.get(), stats, counters), pipeline);
+        }
+        executor.spawn(animateAscii(executor, frames, grid, opts.live, sinks, counters,
+            opts.hud ? &hud : nullptr, stats, opts.stats ? &writeStats : nullptr, launchTime),
+            pipeline);
+        if (opts.interactive) {
+            executor.spawn(steerView(executor, keyboard, view, done), controls);
+        }
+        if (onTerminal) {
+            executor.spawn(followTerminal(executor, grid, requested, done), controls);
+        }
+        pipeline.join();
+        done = true;
+        controls.join();
+    }
+    keyboard.close();
 
-    loadFrames(cap, asciiFrames, opts, opts.targetHeight, opts.targetWidth);
-    animateAscii(asciiFrames, delayMs);
+    if (opts.stats) {
+        stats.merge(writeStats);
+        printStats(stats, std::cerr);
+    }
 
     return 0;
 }
@@ -122,9 +457,14 @@ int main(int argc, char** argv) {
 /* --- Function Definitions --- */
 
 int getOptions(Options &opts, int argc, char** argv) {
-    opts.videoPath = argv[1];
+    // The input comes first, unless a playlist names the inputs
+    int first = 1;
+    if (strncmp(argv[1], "--", 2) != 0) {
+        opts.videoPath = argv[1];
+        first = 2;
+    }
 
-    for (int i = 2; i < argc; i++) {
+    for (int i = first; i < argc; i++) {
         if (strncmp(argv[i], "--color=", 8) == 0) {
             std::string mode = argv[i] + 8; // Truncate "--color="
             if      (mode == "none") { opts.colorMode = ColorMode::None; }
@@ -170,6 +510,123 @@ int getOptions(Options &opts, int argc, char** argv) {
                 std::cerr << "Error: Invalid framerate value\n";
                 return 1;
             }
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            try {
+                int threads = std::stoi(argv[i] + 10);
+                if (threads < MIN_THREADS || threads > MAX_THREADS) {
+                    std::cerr << "Error: Thread count is out of bounds\n";
+                    return 1;
+                }
+                opts.threads = threads;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Invalid thread count\n";
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--parallel=", 11) == 0) {
+            std::string mode = argv[i] + 11;
+            if      (mode == "frames") { opts.parallelism = Parallelism::Frames; }
+            else if (mode == "rows")   { opts.parallelism = Parallelism::Rows; }
+            else {
+                std::cerr << "Unknown parallel mode: " << mode << '\n';
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--decode-threads=", 17) == 0) {
+            try {
+                int threads = std::stoi(argv[i] + 17);
+                if (threads < MIN_DECODE_THREADS || threads > MAX_THREADS) {
+                    std::cerr << "Error: Decoder thread count is out of bounds\n";
+                    return 1;
+                }
+                opts.decodeThreads = threads;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Invalid decoder thread count\n";
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--backend=", 10) == 0) {
+            std::string name = argv[i] + 10;
+            auto it = std::find_if(std::begin(BACKENDS), std::end(BACKENDS),
+                [&](const auto& b) { return name == b.first; });
+            if (it == std::end(BACKENDS)) {
+                std::cerr << "Unknown backend: " << name << '\n';
+                return 1;
+            }
+            if (it->second != cv::CAP_ANY && !cv::videoio_registry::hasBackend(it->second)) {
+                std::cerr << "Error: This OpenCV build has no " << name << " backend\n";
+                return 1;
+            }
+            opts.backend = it->second;
+        } else if (strncmp(argv[i], "--decode-opt=", 13) == 0) {
+            std::string option = argv[i] + 13;
+            const size_t eq = option.find('=');
+            if (eq == 0 || eq == std::string::npos || eq + 1 == option.size()) {
+                std::cerr << "Error: --decode-opt needs key=value\n";
+                return 1;
+            }
+            opts.decodeOptions.emplace_back(option.substr(0, eq), option.substr(eq + 1));
+        } else if (strncmp(argv[i], "--crop=", 7) == 0) {
+            std::string mode = argv[i] + 7;
+            if      (mode == "auto") { opts.autoCrop = true; }
+            else if (mode == "none") { opts.autoCrop = false; }
+            else {
+                std::cerr << "Unknown crop mode: " << mode << '\n';
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--roi=", 6) == 0) {
+            if (!parseRoi(argv[i] + 6, opts.roi)) {
+                std::cerr << "Error: --roi needs x,y,w,h with a positive size\n";
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--playlist=", 11) == 0) {
+            opts.playlist = argv[i] + 11;
+            if (opts.playlist.empty()) {
+                std::cerr << "Error: --playlist needs a file path\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--loop") == 0) {
+            opts.loops = 0;
+        } else if (strncmp(argv[i], "--loop=", 7) == 0) {
+            try {
+                int loops = std::stoi(argv[i] + 7);
+                if (loops < 1) {
+                    std::cerr << "Error: Loop count must be at least 1\n";
+                    return 1;
+                }
+                opts.loops = loops;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: Invalid loop count\n";
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--interactive") == 0) {
+            opts.interactive = true;
+        } else if (strcmp(argv[i], "--full-decode") == 0) {
+            opts.fullDecode = true;
+        } else if (strcmp(argv[i], "--live") == 0) {
+            opts.live = true;
+        } else if (strncmp(argv[i], "--resize=", 9) == 0) {
+            std::string method = argv[i] + 9;
+            if      (method == "auto")    { opts.resizeMethod = ResizeMethod::Auto; }
+            else if (method == "area")    { opts.resizeMethod = ResizeMethod::Area; }
+            else if (method == "pyramid") { opts.resizeMethod = ResizeMethod::Pyramid; }
+            else {
+                std::cerr << "Unknown resize method: " << method << '\n';
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            opts.stats = true;
+        } else if (strcmp(argv[i], "--hud") == 0) {
+            opts.hud = true;
+        } else if (strncmp(argv[i], "--metrics=", 10) == 0) {
+            opts.metricsTarget = argv[i] + 10;
+            if (opts.metricsTarget.empty()) {
+                std::cerr << "Error: --metrics needs a file path or [host]:port\n";
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--tee=", 6) == 0) {
+            opts.teePath = argv[i] + 6;
+            if (opts.teePath.empty()) {
+                std::cerr << "Error: --tee needs a file path\n";
+                return 1;
+            }
         } else if (strcmp(argv[i], "--help") == 0) {
             printHelp();
             return 1;
@@ -180,12 +637,316 @@ int getOptions(Options &opts, int argc, char** argv) {
         }
     }
 
+    if (!opts.videoPath && opts.playlist.empty()) {
+        std::cerr << "Error: No video path or --playlist given\n";
+        return 1;
+    }
+    if (opts.videoPath && !opts.playlist.empty()) {
+        std::cerr << "Error: Give either a video path or --playlist, not both\n";
+        return 1;
+    }
+    // Entries differ in size, so a region or a zoom would not carry over
+    if (!opts.playlist.empty() && (opts.live || opts.interactive || !opts.roi.empty())) {
+        std::cerr << "Error: --playlist cannot be combined with --live, --roi or --interactive\n";
+        return 1;
+    }
+
     return 0;
 }
 
-void getTargetDimensions(const cv::VideoCapture& cap, Options& opts) {
-    double videoWidth = cap.get(cv::CAP_PROP_FRAME_WIDTH);
-    double videoHeight = cap.get(cv::CAP_PROP_FRAME_HEIGHT);
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+void noteResize(int) {
+    terminalResized = 1;
+}
+
+bool parseRoi(const char* text, cv::Rect& roi) {
+    int x, y, w, h;
+    char extra;
+    if (std::sscanf(text, "%d,%d,%d,%d%c", &x, &y, &w, &h, &extra) != 4) { return false; }
+    if (x < 0 || y < 0 || w <= 0 || h <= 0) { return false; }
+    roi = cv::Rect(x, y, w, h);
+    return true;
+}
+
+bool openSource(Source& source, Options& opts) {
+    const std::string path = opts.videoPath;
+    cv::VideoCapture& cap = source.cap;
+
+    if (isImageSequence(path)) {
+        opts.source = SourceKind::Images;
+        if (opts.live) {
+            std::cerr << "Error: --live needs a video, device or stream\n";
+            return false;
+        }
+        source.images = listImageSequence(path);
+        if (source.images.empty()) {
+            std::cerr << "Error: No images found for " << path << '\n';
+            return false;
+        }
+        // The grid is sized for the first image; later ones are scaled to it
+        const cv::Mat first = cv::imread(source.images.front(), cv::IMREAD_COLOR);
+        if (first.empty()) {
+            std::cerr << "Error: Could not read " << source.images.front() << '\n';
+            return false;
+        }
+        source.size = first.size();
+        source.crop = cv::Rect(0, 0, source.size.width, source.size.height);
+        return true;
+    }
+
+    std::vector<int>& params = source.params;
+    if (!captureParams(opts, params, source.ffmpegOptions)) {
+        return false;
+    }
+
+    // A bare number of up to two digits is a capture device index
+    const bool index = !path.empty() && path.size() <= 2 &&
+        std::all_of(path.begin(), path.end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (index) {
+        opts.source = SourceKind::Device;
+    } else {
+        if (path.rfind("/dev/video", 0) == 0) {
+            opts.source = SourceKind::Device;
+        }
+        for (const char* scheme : LIVE_SCHEMES) {
+            if (path.rfind(scheme, 0) == 0) { opts.source = SourceKind::Stream; }
+        }
+    }
+    if (!openCapture(cap, path, index ? std::stoi(path) : -1, opts.backend, params,
+            source.ffmpegOptions)) {
+        std::cerr << "Error: Could not open video\n";
+        return false;
+    }
+    source.size = cv::Size(static_cast<int>(cap.get(cv::CAP_PROP_FRAME_WIDTH)),
+                           static_cast<int>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)));
+    source.crop = cv::Rect(0, 0, source.size.width, source.size.height);
+    source.fps = cap.get(cv::CAP_PROP_FPS);
+
+    if (opts.source != SourceKind::File) { opts.live = true; }
+    // Ask the backend not to queue frames of its own; not every backend can
+    if (opts.live) { cap.set(cv::CAP_PROP_BUFFERSIZE, 1); }
+    return true;
+}
+
+// Open-time capture properties for --decode-threads and --decode-opt. Keys
+// that are not generic properties are FFmpeg options, which OpenCV takes
+// from the OPENCV_FFMPEG_CAPTURE_OPTIONS environment variable (see
+// openCapture).
+bool captureParams(const Options& opts, std::vector<int>& params, std::string& ffmpegOptions) {
+    if (opts.decodeThreads >= 0) {
+        params.push_back(cv::CAP_PROP_N_THREADS);
+        params.push_back(opts.decodeThreads);
+    }
+
+    for (const auto& [key, value] : opts.decodeOptions) {
+        auto it = std::find_if(std::begin(CAPTURE_PROPERTIES), std::end(CAPTURE_PROPERTIES),
+            [&](const auto& p) { return key == p.first; });
+        if (it != std::end(CAPTURE_PROPERTIES)) {
+            try {
+                params.push_back(it->second);
+                params.push_back(std::stoi(value));
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << key << " needs an integer value\n";
+                return false;
+            }
+            continue;
+        }
+        if (opts.backend != cv::CAP_ANY && opts.backend != cv::CAP_FFMPEG) {
+            std::cerr << "Error: Only the ffmpeg backend takes option " << key << '\n';
+            return false;
+        }
+        if (!ffmpegOptions.empty()) { ffmpegOptions += '|'; }
+        ffmpegOptions += key + ';' + value;
+    }
+    return true;
+}
+
+// Open `cap` on device `index` if it is not negative, else on `path`, with
+// `ffmpegOptions` in effect. OpenCV reads FFmpeg options only from the
+// process-wide OPENCV_FFMPEG_CAPTURE_OPTIONS while a capture opens, and the
+// next playlist entry opens on another thread while the current one may be
+// rewound. So every open goes through here: the variable is set, the
+// capture opened and the variable restored under one lock, and an open
+// never sees another's options. Without options the user's own setting, if
+// any, is left alone.
+bool openCapture(cv::VideoCapture& cap, const std::string& path, int index, int backend,
+        const std::vector<int>& params, const std::string& ffmpegOptions) {
+    constexpr const char* VARIABLE = "OPENCV_FFMPEG_CAPTURE_OPTIONS";
+    std::lock_guard<std::mutex> lock(captureOpenMutex);
+
+    const char* previous = ffmpegOptions.empty() ? nullptr : std::getenv(VARIABLE);
+    const std::string saved = previous ? previous : "";
+    if (!ffmpegOptions.empty()) {
+#ifdef _WIN32
+        _putenv_s(VARIABLE, ffmpegOptions.c_str());
+#else
+        setenv(VARIABLE, ffmpegOptions.c_str(), 1);
+#endif
+    }
+
+    const bool opened = index >= 0 ? cap.open(index, backend, params)
+                                   : cap.open(path, backend, params);
+
+    if (!ffmpegOptions.empty()) {
+#ifdef _WIN32
+        _putenv_s(VARIABLE, saved.c_str());     // An empty value removes it
+#else
+        if (previous) {
+            setenv(VARIABLE, saved.c_str(), 1);
+        } else {
+            unsetenv(VARIABLE);
+        }
+#endif
+    }
+    return opened;
+}
+
+// Look for black bars in frames spread over the first CROP_SAMPLE_SECONDS
+// and crop them (see letterbox.hpp). Only files and image sequences can be
+// sampled ahead of playback; a file is rewound afterwards. False only if it
+// could not be rewound.
+bool detectCrop(Source& source, const Options& opts) {
+    if (opts.source != SourceKind::File && opts.source != SourceKind::Images) { return true; }
+
+    const double fps = source.fps > 0 ? source.fps : DEFAULT_FRAMERATE;
+    int span = std::max(1, static_cast<int>(fps * CROP_SAMPLE_SECONDS));
+    if (!source.images.empty()) { span = std::min(span, static_cast<int>(source.images.size())); }
+    const int step = std::max(1, span / CROP_SAMPLES);
+
+    BorderDetector detector(source.size);
+    cv::Mat frame;
+    if (!source.images.empty()) {
+        for (int i = 0; i < span; i += step) {
+            detector.add(cv::imread(source.images[i], cv::IMREAD_COLOR));
+        }
+    } else {
+        // Frames between samples are only grabbed, which skips the conversion to BGR
+        for (int i = 0; i < span; i++) {
+            const bool sample = i % step == 0;
+            if (sample ? !source.cap.read(frame) : !source.cap.grab()) { break; }
+            if (sample) { detector.add(frame); }
+        }
+        const bool rewound = source.cap.set(cv::CAP_PROP_POS_FRAMES, 0) &&
+            source.cap.get(cv::CAP_PROP_POS_FRAMES) == 0;
+        if (!rewound && !openCapture(source.cap, opts.videoPath, -1, opts.backend,
+                source.params, source.ffmpegOptions)) {
+            return false;
+        }
+    }
+    source.crop = detector.content();
+    return true;
+}
+
+// Switch to the smallest decode that still covers the grid (see
+// decode_scale.hpp) where the decoder can do it; otherwise leave the source
+// at full resolution. False only if the capture could not be reopened.
+bool reduceDecode(Source& source, const Options& opts) {
+    const int scale = chooseDecodeScale(source.crop.size(),
+        cv::Size(opts.targetWidth, opts.targetHeight));
+    if (scale == 1) { return true; }
+
+    if (!source.images.empty()) {
+        // JPEG scales in the DCT; other formats decode in full and are reduced after
+        source.imreadFlags = reducedImreadFlags(scale);
+        source.size = reducedSize(source.size, scale);
+        source.crop = reducedRect(source.crop, scale, source.size);
+        source.decodeScale = scale;
+        return true;
+    }
+
+    // Only FFmpeg has lowres, and probing it means reopening, which only a file allows
+    if (opts.source != SourceKind::File || source.cap.getBackendName() != "FFMPEG") {
+        return true;
+    }
+
+    openCapture(source.cap, opts.videoPath, -1, cv::CAP_FFMPEG, source.params,
+        withLowres(source.ffmpegOptions, scale));
+
+    // Decoders without lowres ignore the option, so check what comes out
+    const cv::Size expected = reducedSize(source.size, scale);
+    cv::Mat probe;
+    const bool reduced = source.cap.isOpened() && source.cap.read(probe) &&
+        probe.size() == expected && source.cap.set(cv::CAP_PROP_POS_FRAMES, 0) &&
+        source.cap.get(cv::CAP_PROP_POS_FRAMES) == 0;
+    if (!reduced && !openCapture(source.cap, opts.videoPath, -1, opts.backend,
+            source.params, source.ffmpegOptions)) {
+        return false;
+    }
+    if (opts.live) { source.cap.set(cv::CAP_PROP_BUFFERSIZE, 1); }
+    if (reduced) {
+        source.size = expected;
+        source.crop = reducedRect(source.crop, scale, source.size);
+        source.decodeScale = scale;
+    }
+    return true;
+}
+
+// FFmpeg `options` plus decoding at 1/scale size
+std::string withLowres(const std::string& options, int scale) {
+    std::string lowres = options;
+    if (!lowres.empty()) { lowres += '|'; }
+    return lowres + "lowres;" + std::to_string(lowresLevel(scale));
+}
+
+// Back to frame `frame` for another pass: the first, or where replayed
+// cells left off. The decoder stays open where the backend can seek;
+// otherwise the file is reopened, at the same reduced decode, and the frames
+// before `frame` are skipped. False if it could be neither.
+bool rewindSource(Source& source, const Options& opts, size_t frame) {
+    if (!source.images.empty()) {
+        source.firstImage = std::min(frame, source.images.size());
+        return true;
+    }
+    const double position = static_cast<double>(frame);
+    if (source.cap.set(cv::CAP_PROP_POS_FRAMES, position) &&
+            source.cap.get(cv::CAP_PROP_POS_FRAMES) == position) {
+        return true;
+    }
+    if (source.decodeScale == 1) {
+        openCapture(source.cap, opts.videoPath, -1, opts.backend, source.params,
+            source.ffmpegOptions);
+    } else {
+        openCapture(source.cap, opts.videoPath, -1, cv::CAP_FFMPEG, source.params,
+            withLowres(source.ffmpegOptions, source.decodeScale));
+    }
+    for (size_t i = 0; i < frame && source.cap.isOpened(); i++) {
+        if (!source.cap.grab()) { return false; }
+    }
+    return source.cap.isOpened();
+}
+
+// How --loop plays passes after the first. The first pass is kept as cells
+// (see cell_cache.hpp) if they fit the budget and every pass would show the
+// same frames; otherwise each pass streams the source again. `strategy`
+// says which, and why, for --stats.
+std::unique_ptr<CellCache> loopCache(const Source& source, const Options& opts,
+        const std::vector<std::string>& playlist, cv::Size grid, std::string& strategy) {
+    if (opts.loops == 1) { return nullptr; }
+
+    const double count = source.images.empty() ? source.cap.get(cv::CAP_PROP_FRAME_COUNT)
+                                               : static_cast<double>(source.images.size());
+    const size_t frames = count >= 1 ? static_cast<size_t>(count) : 0;
+    const std::string why = loopStreamReason(frames, grid, opts.colorMode, playlist.size() > 1,
+        opts.interactive);
+    if (!why.empty()) {
+        strategy = "streaming every pass (" + why + ")";
+        return nullptr;
+    }
+
+    const size_t bytes = CellCache::bytesFor(frames, grid, opts.colorMode);
+    char line[96];
+    std::snprintf(line, sizeof(line), "replaying %zu frames from cells (%.1f MB)",
+        frames, bytes / 1048576.0);
+    strategy = line;
+    return std::make_unique<CellCache>(frames, grid, opts.colorMode);
+}
+
+void getTargetDimensions(cv::Size sourceSize, Options& opts) {
+    double videoWidth = sourceSize.width;
+    double videoHeight = sourceSize.height;
     double videoAspect = videoWidth / videoHeight;
     double charAspect = 0.5;
 
@@ -197,117 +958,680 @@ void getTargetDimensions(const cv::VideoCapture& cap, Options& opts) {
     opts.targetWidth = std::clamp(opts.targetWidth, MIN_WIDTH, MAX_WIDTH);
 }
 
-double getDelayMs(const cv::VideoCapture& cap, const Options& opts) {
+// Shrink `grid` to fit a rows x cols terminal, keeping its shape. The newline
+// after the last row needs a row of its own.
+cv::Size fitGrid(cv::Size grid, int rows, int cols) {
+    const double scale = std::min({1.0, static_cast<double>(cols) / grid.width,
+                                   static_cast<double>(rows - 1) / grid.height});
+    return cv::Size(std::clamp(static_cast<int>(grid.width * scale), MIN_WIDTH, MAX_WIDTH),
+                    std::clamp(static_cast<int>(grid.height * scale), MIN_HEIGHT, MAX_HEIGHT));
+}
+
+double getDelayMs(double sourceFps, const Options& opts) {
     if (opts.framerate != -1) { return 1000.0 / opts.framerate; }
 
-    double fps = cap.get(cv::CAP_PROP_FPS);
+    double fps = sourceFps;
     if (fps <= 0) { fps = DEFAULT_FRAMERATE; }
     return 1000.0 / fps;
 }
 
-void loadFrames(cv::VideoCapture& cap, std::vector<std::string>& asciiFrames,
-        const Options& opts, int height, int width) {
-    cv::Mat frame, gray, resized, resizedColor;
-    const cv::Size size(width, height);
+// How long each frame of `source` stays on screen
+std::chrono::steady_clock::duration framePeriod(const Source& source, const Options& opts) {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double, std::milli>(getDelayMs(source.fps, opts)));
+}
 
-    while (cap.read(frame)) {
-        std::ostringstream frameStream;
+// The part of a decoded frame that is shown: a view into it, not a copy.
+// Frames of another size than the first (image sequences) are shown whole.
+cv::Mat shownPart(const cv::Mat& frame, const Source& source, const Viewport& view) {
+    if (frame.size() != source.size) { return frame; }
+    return frame(view.region());
+}
 
-        if (opts.colorMode == ColorMode::ANSI || opts.colorMode == ColorMode::Full) {
-            cv::resize(frame, resizedColor, size, 0, 0, cv::INTER_AREA);
-        } else {
-            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-            cv::resize(gray, resized, size, 0, 0, cv::INTER_AREA);
-        }
-
-        for (int y = 0; y < height; y++) {
-            const cv::Vec3b* colorRowPtr = (opts.colorMode != ColorMode::None)
-                ? resizedColor.ptr<cv::Vec3b>(y) : nullptr;
-            const uchar* grayRowPtr = (opts.colorMode == ColorMode::None)
-                ? resized.ptr<uchar>(y) : nullptr;
-
-            for (int x = 0; x < width; x++) {
-                if (opts.colorMode == ColorMode::ANSI) {
-                    const cv::Vec3b& px = colorRowPtr[x];
-                    uchar b = px[0], g = px[1], r = px[2];
-
-                    int brightness = std::clamp((r + g + b) / 3, 0, 255);
-
-                    frameStream << rgbToAnsiColor(r, g, b, brightness);
-                    frameStream << brightnessToAscii(brightness);
-                    frameStream << Color::RESET;
-                } else if (opts.colorMode == ColorMode::Full) {
-                    const cv::Vec3b& px = colorRowPtr[x];
-                    uchar b = px[0], g = px[1], r = px[2];
-
-                    int brightness = std::clamp((r + g + b) / 3, 0, 255);
-
-                    frameStream << rgbToTrueColor(r, g, b, brightness);
-                } else {
-                    uchar px = grayRowPtr[x];
-                    int brightness = std::clamp(static_cast<int>(px), 0, 255);
-                    int index = brightness * (asciiLen - 1) / 255;
-                    frameStream << asciiChars[index];
-                }
+// Open the next playable playlist entry from `index` on, for the grid the
+// first entry set; entries that cannot be played are skipped. Opening
+// blocks this pool thread, which is why it has one. `item` stays empty if
+// no entry is left.
+Task openNextItem(const std::vector<std::string>& playlist, size_t& index,
+        const Options& opts, cv::Size grid, std::unique_ptr<PlaylistItem>& item) {
+    while (index < playlist.size()) {
+        const std::string& path = playlist[index++];
+        auto next = std::make_unique<PlaylistItem>();
+        next->opts = opts;
+        next->opts.videoPath = path.c_str();
+        next->opts.source = SourceKind::File;
+        next->opts.targetWidth = grid.width;
+        next->opts.targetHeight = grid.height;
+
+        Source& source = next->source;
+        const bool playable = openSource(source, next->opts) && !next->opts.live &&
+            (!opts.autoCrop || detectCrop(source, next->opts)) &&
+            (opts.fullDecode || reduceDecode(source, next->opts));
+        if (!playable) {
+            std::cerr << "Error: Skipping " << path << '\n';
+            continue;
+        }
+        // Entries of another shape than the first are scaled to its grid
+        next->view.emplace(source.crop, grid);
+        item = std::move(next);
+        break;
+    }
+    co_return;
+}
+
+// Play `source`, then each further playlist entry, as one stream of frames
+// numbered on from each other. The next entry is opened while the current
+// one plays. Its first frames are converted as soon as the current one has
+// been decoded, while the ring still holds the current one's last frames,
+// so the player goes from one to the next without a gap. With --loop the
+// playlist plays again, from `cache` when the first pass was kept.
+Task loadPlaylist(Executor& executor, Source& source, const Viewport& view,
+        FrameRing& frames, const Options& opts, const std::vector<std::string>& playlist,
+        cv::Size requested, const GridTarget& grid, CellCache* cache, PipelineStats& stats,
+        PipelineCounters& counters) {
+    uint64_t seq = 0;
+    uint64_t cached = 0;
+    uint32_t cachedGeneration = 0;
+    std::unique_ptr<PlaylistItem> current, next;
+    std::vector<PipelineStats> replayStats(frameWorkers(opts));
+    bool replayed = false;
+
+    for (int pass = 0; opts.loops == 0 || pass < opts.loops; pass++) {
+        const uint64_t passStart = seq;
+        // Cells only replay for the grid they were converted for
+        if (pass == 1 && cache) {
+            cached = seq;
+            cachedGeneration = grid.load().generation;
+            if (!cache->complete(cached, cachedGeneration)) {
+                cache = nullptr;
+                stats.loop = "streaming every pass (the first pass could not be kept)";
+            }
+        }
+        if (pass > 1 && cache && grid.load().generation != cachedGeneration) {
+            cache = nullptr;
+            stats.loop = "replaying cells, then streaming after the grid changed";
+        }
+
+        size_t resumeAt = 0;    // Frame of the source this pass streams from
+        if (pass > 0 && cache) {
+            std::atomic<size_t> next{0};
+            TaskGroup replayers;
+            for (size_t i = 0; i < replayStats.size(); i++) {
+                executor.spawn(replayCells(*cache, cached, next, seq, frames, opts, grid,
+                    framePeriod(source, opts), cachedGeneration, replayStats[i], counters),
+                    replayers);
+            }
+            co_await replayers.wait();
+            // Every claimed frame was played, so they are the start of the pass
+            const size_t played = std::min(next.load(), static_cast<size_t>(cached));
+            seq += played;
+            replayed = true;
+            if (frames.closed()) { break; }
+            if (played == cached) { continue; }
+
+            // The grid changed during the pass: the rest of it, and every
+            // pass after it, streams from the source
+            cache = nullptr;
+            stats.loop = "replaying cells, then streaming after the grid changed";
+            resumeAt = played;
+        }
+        if (pass > 0 && !rewindSource(source, opts, resumeAt)) {
+            std::cerr << "Error: Could not rewind video\n";
+            break;
+        }
+
+        size_t index = 1;
+        Source* playing = &source;
+        const Viewport* shown = &view;
+        const Options* itemOpts = &opts;
+        for (;;) {
+            // The first pass of the first entry fills the cache; its frames
+            // are numbered from 0, so their numbers index it
+            CellCache* filling = pass == 0 && playing == &source ? cache : nullptr;
+            TaskGroup opener, loader;
+            executor.spawn(openNextItem(playlist, index, opts, requested, next), opener);
+            executor.spawn(loadFrames(executor, *playing, *shown, frames, *itemOpts, grid,
+                filling, seq, stats, counters), loader);
+            co_await loader.wait();
+            co_await opener.wait();
+            if (!next || frames.closed()) { break; }
+
+            current = std::move(next);
+            playing = &current->source;
+            shown = &*current->view;
+            itemOpts = &current->opts;
+        }
+        // A pass without frames would repeat forever
+        if (frames.closed() || seq == passStart) { break; }
+    }
+    if (replayed) {
+        for (const PipelineStats& s : replayStats) { stats.merge(s); }
+    }
+    frames.close();
+}
+
+Task loadFrames(Executor& executor, Source& source, const Viewport& view, FrameRing& frames,
+        const Options& opts, const GridTarget& grid, CellCache* cache, uint64_t& seq,
+        PipelineStats& stats, PipelineCounters& counters) {
+    const int threads = frameWorkers(opts);
+
+    // decoder -(SPSC)-> dispatcher -(MPMC)-> workers -> FrameRing (reorder).
+    // Still images decode independently of each other, so for a sequence the
+    // workers decode too and the "decoder" only hands out file names; the
+    // ring keeps them in order and buffers them ahead of playback.
+    SpscQueue<FrameTask> decoded(DECODE_QUEUE_DEPTH);
+    MpmcQueue<FrameTask> work(DISPATCH_BATCH * 2);
+
+    // Enough buffers to keep the decode queue full while every worker holds
+    // one; with fewer the decoder simply waits
+    FramePool pool(DECODE_QUEUE_DEPTH + threads + 1, source.size, view.sizes(),
+        grid.load().size, opts.colorMode);
+
+    TaskGroup decoder, workers;
+    PipelineStats decodeStats;
+    if (source.images.empty()) {
+        executor.spawn(decodeFrames(source.cap, pool, decoded, seq, opts, decodeStats,
+            counters), decoder);
+    } else {
+        executor.spawn(queueImages(source.images, source.firstImage, pool, decoded, seq,
+            counters), decoder);
+    }
+    std::vector<PipelineStats> workerStats(threads);
+    for (int i = 0; i < threads; i++) {
+        executor.spawn(convertFrames(work, pool, frames, opts, source, view, grid, cache,
+            workerStats[i], counters), workers);
+    }
+
+    // Dispatch: hand decoded frames to whichever worker is free. The work
+    // queue only closes early when playback has stopped.
+    FrameTask batch[DISPATCH_BATCH];
+    bool stopped = false;
+    while (!stopped) {
+        const size_t n = co_await decoded.popBatchAsync(batch, DISPATCH_BATCH);
+        if (n == 0) { break; }
+        PipelineCounters::add(counters.framesDispatched, n);
+        for (size_t i = 0; i < n; i++) {
+            if (stopped || !co_await work.pushAsync(batch[i])) {
+                stopped = true;
+                pool.giveBack(batch[i].buffers);
+            }
+        }
+    }
+
+    // Workers drain what is queued; closing the decode queue and the pool
+    // unblocks the decoder if playback stopped early. The ring stays open
+    // for whatever plays next.
+    work.close();
+    co_await workers.wait();
+    decoded.close();
+    pool.close();
+    co_await decoder.wait();
+
+    // This task measured nothing itself; availability comes from the probes
+    const PipelineStats& probed = source.images.empty() ? decodeStats : workerStats[0];
+    stats.countersAvailable = probed.countersAvailable;
+    stats.allocsAvailable = probed.allocsAvailable;
+    stats.merge(decodeStats);
+    for (const PipelineStats& s : workerStats) { stats.merge(s); }
+}
+
+Task decodeFrames(cv::VideoCapture& cap, FramePool& pool,
+        SpscQueue<FrameTask>& decoded, uint64_t& seq, const Options& opts,
+        PipelineStats& stats, PipelineCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(opts.stats ? &stats : nullptr);
+
+    while (std::optional<FrameBuffers*> borrowed = co_await pool.borrowAsync()) {
+        FrameBuffers* buf = *borrowed;
+        probe.begin();
+        const auto start = Clock::now();
+        // Reading blocks this pool thread, which is why the decoder has one
+        if (!cap.read(buf->source)) {
+            pool.giveBack(buf);
+            break;
+        }
+        probe.lap(Stage::Decode);
+        stats.framesDecoded++;
+        buf->captured = Clock::now();
+        counters.decodeLatency.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(buf->captured - start).count()));
+
+        if (!co_await decoded.pushAsync({seq++, buf})) {
+            pool.giveBack(buf);
+            break;
+        }
+        PipelineCounters::add(counters.framesDecoded, 1);
+    }
+    decoded.close();
+}
+
+Task queueImages(const std::vector<std::string>& images, size_t first, FramePool& pool,
+        SpscQueue<FrameTask>& decoded, uint64_t& seq, PipelineCounters& counters) {
+    for (size_t i = first; i < images.size(); i++) {
+        std::optional<FrameBuffers*> buf = co_await pool.borrowAsync();
+        if (!buf) { break; }
+        if (!co_await decoded.pushAsync({seq++, *buf, &images[i]})) {
+            pool.giveBack(*buf);
+            break;
+        }
+        PipelineCounters::add(counters.framesDecoded, 1);
+    }
+    decoded.close();
+}
+
+Task convertFrames(MpmcQueue<FrameTask>& work, FramePool& pool, FrameRing& frames,
+        const Options& opts, const Source& source, const Viewport& view,
+        const GridTarget& grid, CellCache* cache, PipelineStats& stats,
+        PipelineCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(opts.stats ? &stats : nullptr);
+    auto elapsedNs = [](Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+    };
+    const auto period = framePeriod(source, opts);
+
+    while (std::optional<FrameTask> task = co_await work.popAsync()) {
+        FrameBuffers* buf = task->buffers;
+        if (task->image) {
+            probe.begin();
+            const auto readStart = Clock::now();
+            // imread cannot decode into an existing buffer, so this allocates
+            buf->source = cv::imread(*task->image, source.imreadFlags);
+            probe.lap(Stage::Decode);
+            if (!buf->source.empty()) { stats.framesDecoded++; }
+            buf->captured = Clock::now();
+            counters.decodeLatency.observe(elapsedNs(readStart, buf->captured));
+        }
+
+        // The grid is read once per frame; a resize applies from the next one
+        const GridTarget::Grid target = grid.load();
+        probe.begin();
+        const auto start = Clock::now();
+        // An unreadable image leaves the previous frame on screen
+        if (buf->source.empty()) {
+            if (cache) { cache->store(task->seq, cv::Mat(), target.generation); }
+            FrameText* text = co_await frames.acquire(task->seq);
+            if (text) {
+                for (std::string& segment : text->segments) { segment.clear(); }
+                text->captured = buf->captured;
+                text->generation = target.generation;
+                text->period = period;
+                PipelineCounters::add(counters.framesReady, 1);
+                frames.publish(task->seq);
+            } else {
+                work.close();
             }
-            frameStream << '\n';
+            pool.giveBack(buf);
+            continue;
+        }
+        resizeFrame(shownPart(buf->source, source, view), buf->downscaled, buf->luma, buf->reduced,
+            opts.colorMode, target.size, opts.resizeMethod);
+        if (cache) { cache->store(task->seq, buf->downscaled, target.generation); }
+        probe.lap(Stage::Resize);
+        const auto resizedAt = Clock::now();
+
+        // Waiting for the frame's slot is not part of any stage
+        FrameText* text = co_await frames.acquire(task->seq);
+        if (!text) {
+            // Playback stopped: stop the dispatcher, then drain so every
+            // buffer goes back to the pool
+            work.close();
+            pool.giveBack(buf);
+            continue;
         }
-        asciiFrames.push_back(frameStream.str());
+        probe.begin();
+        const auto encodeStart = Clock::now();
+        convertFrameBands(buf->downscaled, opts.colorMode, text->segments);
+        probe.lap(Stage::Encode);
+        const auto encoded = Clock::now();
+        text->captured = buf->captured;
+        text->generation = target.generation;
+        text->period = period;
+        pool.giveBack(buf);
+        stats.frames++;
+
+        counters.resizeLatency.observe(elapsedNs(start, resizedAt));
+        counters.encodeLatency.observe(elapsedNs(encodeStart, encoded));
+        PipelineCounters::add(counters.convertNs,
+            elapsedNs(start, resizedAt) + elapsedNs(encodeStart, encoded));
+        PipelineCounters::add(counters.framesConverted, 1);
+        PipelineCounters::add(counters.framesReady, 1);
+
+        frames.publish(task->seq);
     }
 }
 
-void animateAscii(const std::vector<std::string>& asciiFrames, double delayMs) {
-    for (const auto& frameStr : asciiFrames) {
-        clearScreen();
-        std::cout << frameStr << std::flush;
-        std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(delayMs)));
+// Frames of a pass kept as cells, numbered on from `base`: only the encode
+// runs again. Replayers claim frames in order from `next`, so the frames
+// claimed are always the start of the pass. The cells are for grid
+// `generation`; once the terminal has another, no further frame is claimed,
+// and `next` tells where streaming has to take over.
+Task replayCells(const CellCache& cache, size_t count, std::atomic<size_t>& next,
+        uint64_t base, FrameRing& frames, const Options& opts, const GridTarget& grid,
+        std::chrono::steady_clock::duration period, uint32_t generation,
+        PipelineStats& stats, PipelineCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(opts.stats ? &stats : nullptr);
+
+    while (grid.load().generation == generation) {
+        const size_t i = next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count) { break; }
+        FrameText* text = co_await frames.acquire(base + i);
+        if (!text) { break; }
+        probe.begin();
+        const auto start = Clock::now();
+        if (cache.blank(i)) {
+            for (std::string& segment : text->segments) { segment.clear(); }
+        } else {
+            convertFrameBands(cache.cells(i), opts.colorMode, text->segments);
+        }
+        probe.lap(Stage::Encode);
+        const auto encodeNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        text->captured = start;
+        text->generation = generation;
+        text->period = period;
+        stats.frames++;
+
+        counters.encodeLatency.observe(encodeNs);
+        PipelineCounters::add(counters.convertNs, encodeNs);
+        PipelineCounters::add(counters.framesConverted, 1);
+        PipelineCounters::add(counters.framesReady, 1);
+
+        frames.publish(base + i);
     }
 }
 
-inline char brightnessToAscii(int brightness) {
-    int index = brightness * (asciiLen - 1) / 255;
-    return asciiChars[index];
+Task loadLiveFrames(Executor& executor, Source& source, const Viewport& view,
+        FrameRing& frames, const Options& opts, double delayMs, const GridTarget& grid,
+        PipelineStats& stats, PipelineCounters& counters) {
+    // capture -(mailbox, newest only)-> converter -> FrameRing
+    FramePool pool(LIVE_POOL_SIZE, source.size, view.sizes(), grid.load().size,
+        opts.colorMode);
+    Mailbox<FrameBuffers> latest;
+
+    TaskGroup capture, converter;
+    PipelineStats captureStats, convertStats;
+    executor.spawn(captureFrames(executor, source.cap, pool, latest, opts, delayMs,
+        captureStats, counters), capture);
+    executor.spawn(convertLatest(latest, pool, frames, opts, source, view, grid,
+        convertStats, counters), converter);
+
+    // The converter stops when the source ends; closing the mailbox and the
+    // pool unblocks the capture if playback stopped first
+    co_await converter.wait();
+    frames.close();
+    latest.close();
+    pool.close();
+    co_await capture.wait();
+
+    stats.countersAvailable = captureStats.countersAvailable;
+    stats.allocsAvailable = captureStats.allocsAvailable;
+    stats.merge(captureStats);
+    stats.merge(convertStats);
+}
+
+Task captureFrames(Executor& executor, cv::VideoCapture& cap, FramePool& pool,
+        Mailbox<FrameBuffers>& latest, const Options& opts, double delayMs,
+        PipelineStats& stats, PipelineCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(opts.stats ? &stats : nullptr);
+
+    // A file stands in for a camera: it loops, and each frame only exists
+    // from its tick of the camera clock on
+    const bool cameraClock = opts.source == SourceKind::File;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(delayMs));
+    auto captureAt = Clock::now() - period;
+
+    while (std::optional<FrameBuffers*> borrowed = co_await pool.borrowAsync()) {
+        FrameBuffers* buf = *borrowed;
+        if (stopRequested) {
+            pool.giveBack(buf);
+            break;
+        }
+        probe.begin();
+        const auto start = Clock::now();
+        // Devices and streams block here until the next frame arrives
+        bool ok = cap.read(buf->source);
+        if (!ok && cameraClock) {
+            cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+            ok = cap.read(buf->source);
+        }
+        if (!ok) {
+            pool.giveBack(buf);
+            break;
+        }
+        probe.lap(Stage::Decode);
+        stats.framesDecoded++;
+        counters.decodeLatency.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+
+        if (cameraClock) {
+            // A camera that falls behind skips ticks rather than bursting
+            captureAt = std::max(captureAt + period, Clock::now());
+            co_await executor.sleepUntil(captureAt);
+        }
+        buf->captured = Clock::now();
+
+        PipelineCounters::add(counters.framesDecoded, 1);
+        if (FrameBuffers* stale = latest.put(buf)) {
+            PipelineCounters::add(counters.framesStale, 1);
+            pool.giveBack(stale);
+        }
+    }
+    latest.close();
 }
 
-inline const char* rgbToAnsiColor(int r, int g, int b, int brightness) {
-    if (brightness < Color::DARK_THRESHOLD) { return Color::BLACK; }
+Task convertLatest(Mailbox<FrameBuffers>& latest, FramePool& pool, FrameRing& frames,
+        const Options& opts, const Source& source, const Viewport& view,
+        const GridTarget& grid, PipelineStats& stats, PipelineCounters& counters) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(opts.stats ? &stats : nullptr);
+    auto elapsedNs = [](Clock::time_point from, Clock::time_point to) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+    };
+
+    const auto period = framePeriod(source, opts);
 
-    // Check for grayscale (low color variance)
-    int maxC = std::max({r, g, b});
-    int minC = std::min({r, g, b});
-    if (maxC - minC < Color::GRAYSCALE_VARIANCE) {
-        if (brightness > Color::VERY_BRIGHT) { return Color::BRIGHT_WHITE; }
-        if (brightness > Color::BRIGHT) { return Color::WHITE; }
-        return Color::BRIGHT_BLACK;
+    // Claim the slot first and only then take a frame, so the frame converted
+    // is the newest one when there is somewhere to put it
+    for (uint64_t seq = 0;; seq++) {
+        FrameText* text = co_await frames.acquire(seq);
+        if (!text) { break; }
+        FrameBuffers* buf = co_await latest.takeAsync();
+        if (!buf) { break; }
+        PipelineCounters::add(counters.framesDispatched, 1);
+
+        const GridTarget::Grid target = grid.load();
+        probe.begin();
+        const auto start = Clock::now();
+        resizeFrame(shownPart(buf->source, source, view), buf->downscaled, buf->luma, buf->reduced,
+            opts.colorMode, target.size, opts.resizeMethod);
+        probe.lap(Stage::Resize);
+        const auto resizedAt = Clock::now();
+        convertFrameBands(buf->downscaled, opts.colorMode, text->segments);
+        probe.lap(Stage::Encode);
+        const auto encoded = Clock::now();
+        text->captured = buf->captured;
+        text->generation = target.generation;
+        text->period = period;
+        pool.giveBack(buf);
+        stats.frames++;
+
+        counters.resizeLatency.observe(elapsedNs(start, resizedAt));
+        counters.encodeLatency.observe(elapsedNs(resizedAt, encoded));
+        PipelineCounters::add(counters.convertNs, elapsedNs(start, encoded));
+        PipelineCounters::add(counters.framesConverted, 1);
+        PipelineCounters::add(counters.framesReady, 1);
+
+        frames.publish(seq);
     }
+}
 
-    // Classify color
-    bool bright = brightness > Color::MEDIUM_BRIGHT;
-    if (r > g && r > b) { return bright ? Color::BRIGHT_RED : Color::RED; }
-    if (g > r && g > b) { return bright ? Color::BRIGHT_GREEN : Color::GREEN; }
-    if (b > r && b > g) { return bright ? Color::BRIGHT_BLUE : Color::BLUE; }
+// Apply key presses to the view until playback is done. The keyboard is
+// polled on a timer, so no pool thread ever blocks on it.
+Task steerView(Executor& executor, Keyboard& keyboard, Viewport& view,
+        const std::atomic<bool>& done) {
+    const auto period = std::chrono::milliseconds(KEY_POLL_MS);
+    Key keys[MAX_KEYS];
+    while (!done) {
+        co_await executor.sleepUntil(std::chrono::steady_clock::now() + period);
+        const size_t n = keyboard.read(keys, MAX_KEYS);
+        for (size_t i = 0; i < n; i++) {
+            switch (keys[i]) {
+                case Key::Up:      view.pan(0, -1); break;
+                case Key::Down:    view.pan(0, 1);  break;
+                case Key::Left:    view.pan(-1, 0); break;
+                case Key::Right:   view.pan(1, 0);  break;
+                case Key::ZoomIn:  view.zoom(1);    break;
+                case Key::ZoomOut: view.zoom(-1);   break;
+                case Key::Reset:   view.reset();    break;
+                case Key::Quit:    stopRequested = 1; break;
+            }
+        }
+    }
+}
+
+// Re-target the grid when the terminal has been resized. A signal handler
+// can do little safely, so it only raises a flag, which is polled here.
+Task followTerminal(Executor& executor, GridTarget& grid, cv::Size requested,
+        const std::atomic<bool>& done) {
+    const auto period = std::chrono::milliseconds(RESIZE_POLL_MS);
+    while (!done) {
+        co_await executor.sleepUntil(std::chrono::steady_clock::now() + period);
+        if (!terminalResized) { continue; }
+        terminalResized = 0;
+        int rows, cols;
+        if (terminalSize(rows, cols)) { grid.set(fitGrid(requested, rows, cols)); }
+    }
+}
 
-    return Color::WHITE;
+// Whole frames converted at once; row mode keeps frames strictly in order
+int frameWorkers(const Options& opts) {
+    return opts.parallelism == Parallelism::Rows ? 1 : workerCount(opts);
 }
 
-inline std::string rgbToTrueColor(int r, int g, int b, int brightness) {
-    std::string result;
-    result.reserve(32);
-    result += Color::TRUECOLOR;
-    result += std::to_string(r);
-    result += ';';
-    result += std::to_string(g);
-    result += ';';
-    result += std::to_string(b);
-    result += 'm';
-    result += brightnessToAscii(brightness);
-    result += Color::RESET;
+int workerCount(const Options& opts) {
+    if (opts.threads > 0) { return opts.threads; }
 
-    return result;
+    // Leave a core each for the decoder and the player
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(cores - 2, MIN_THREADS, 4);
+}
+
+// `writeStats`, when given, is charged for the write stage; it is kept apart
+// from `stats` because the producers merge into that while frames play
+Task animateAscii(Executor& executor, FrameRing& frames, const GridTarget& grid,
+        bool live, const std::vector<Sink*>& sinks, PipelineCounters& counters, Hud* hud,
+        PipelineStats& stats, PipelineStats* writeStats,
+        std::chrono::steady_clock::time_point launchTime) {
+    using Clock = std::chrono::steady_clock;
+    StageProbe probe(writeStats);
+    std::string overlay;
+    std::vector<std::string_view> parts;
+    double latencySumMs = 0;
+    uint64_t presented = 0;
+    uint32_t shownGeneration = grid.load().generation;
+
+    // Clear once, then redraw each frame in place from the home position
+    for (Sink* sink : sinks) { sink->begin(); }
+
+    // The schedule starts when the first frame is ready, not at launch
+    const FrameText* next = co_await frames.front();
+    FramePacer pacer{Clock::now()};
+
+    for (; next; next = co_await frames.front()) {
+        // Closing the ring from this side winds the producers down
+        if (stopRequested) {
+            frames.close();
+            break;
+        }
+        // Each frame keeps its own source's pace, so playlist entries do too
+        const Clock::duration period = next->period;
+        // Frames converted for a grid the terminal no longer has would garble
+        // it. They take no presentation slot, since they were never due.
+        const GridTarget::Grid target = grid.load();
+        if (next->generation != target.generation) {
+            counters.drop(DropReason::Resized);
+            frames.pop();
+            continue;
+        }
+        // Live sources show the newest frame as soon as it is ready
+        if (live && frames.size() > 1) {
+            counters.drop(DropReason::Superseded);
+            frames.pop();
+            continue;
+        }
+        // Skip frames whose presentation slot has already passed entirely,
+        // as long as a newer frame is ready to take their place
+        if (!live && pacer.missed(Clock::now(), period) && frames.size() > 1) {
+            counters.drop(DropReason::Late);
+            frames.pop();
+            pacer.advance(period);
+            continue;
+        }
+
+        // The first frame at a new grid size redraws the whole screen
+        std::string_view home(CURSOR_HOME, sizeof(CURSOR_HOME) - 1);
+        if (next->generation != shownGeneration) {
+            home = std::string_view(CLEAR_AND_HOME, sizeof(CLEAR_AND_HOME) - 1);
+            shownGeneration = next->generation;
+            if (hud) { hud->move(target.size.height + 1, target.size.width); }
+        }
+
+        probe.begin();
+        overlay.clear();
+        if (hud) { hud->update(counters, overlay); }
+
+        // Row bands go out as they are, gathered into one write per sink
+        parts.clear();
+        parts.emplace_back(home);
+        for (const std::string& segment : next->segments) { parts.emplace_back(segment); }
+        parts.emplace_back(overlay);
+
+        const auto start = Clock::now();
+        for (Sink* sink : sinks) { sink->write(parts.data(), parts.size()); }
+        const auto end = Clock::now();
+        probe.lap(Stage::Write);
+
+        const auto writeNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        PipelineCounters::add(counters.writeNs, writeNs);
+        counters.writeLatency.observe(writeNs);
+        if (!live && pacer.late(start, period)) {
+            PipelineCounters::add(counters.framesLate, 1);
+        }
+        PipelineCounters::add(counters.bytesWritten,
+            home.size() + next->size() + overlay.size());
+        PipelineCounters::add(counters.framesPresented, 1);
+
+        const auto latency = end - next->captured;
+        counters.captureToDisplay.observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+        const double latencyMs = std::chrono::duration<double, std::milli>(latency).count();
+        latencySumMs += latencyMs;
+        stats.captureToDisplayMaxMs = std::max(stats.captureToDisplayMaxMs, latencyMs);
+        frames.pop();
+
+        if (presented++ == 0) {
+            stats.timeToFirstFrameMs =
+                std::chrono::duration<double, std::milli>(end - launchTime).count();
+        }
+
+        if (!live) { co_await executor.sleepUntil(pacer.advance(period)); }
+    }
+
+    if (presented > 0) { stats.captureToDisplayMs = latencySumMs / presented; }
 }
 
 void printHelp() {
-    std::cerr << "Usage: ASCIIAnimator <video_path> [options]\n\n"
+    std::cerr << "Usage: ASCIIAnimator <video_path> [options]\n"
+              << "       ASCIIAnimator --playlist=<file> [options]\n\n"
+              << "The input may also be a capture device (0, /dev/video0), a stream URL,\n"
+              << "or an image sequence: a directory or a quoted pattern like 'out/*.png'.\n\n"
               << "Options:\n"
 
               << "  --color=<mode>  Color mode: none, ansi, full (default: none)\n"
@@ -324,13 +1648,55 @@ void printHelp() {
               << "[" << MIN_FRAMERATE << ", " << MAX_FRAMERATE << "] "
               << "(default: auto)\n"
 
-              << "  --help          Show this help message\n";
-}
+              << "  --threads=<n>   Conversion threads         "
+              << "[" << MIN_THREADS << ", " << MAX_THREADS << "] "
+              << "(default: auto)\n"
 
-void clearScreen() {
-#ifdef _WIN32
-    system("cls");
-#else
-    std::cout << "\033[2J\033[H" << std::flush;
-#endif
+              << "  --parallel=<m>  Split conversion by frames (throughput) or\n"
+              << "                  rows (per-frame latency) (default: frames)\n"
+
+              << "  --crop=<mode>   Black bars: auto (crop bars found in the first\n"
+              << "                  seconds of a file or sequence), none (default: auto)\n"
+
+              << "  --roi=x,y,w,h   Show only this region of the frame, in source pixels\n"
+
+              << "  --interactive   Zoom (+ -), pan (arrows, hjkl) and reset (0) the view\n"
+              << "                  from the keyboard; q quits\n"
+
+              << "  --playlist=<f>  Play the inputs listed in a file, one per line,\n"
+              << "                  gaplessly; the next is opened while one plays\n"
+
+              << "  --loop[=n]      Play n times, or forever; short clips replay from\n"
+              << "                  converted cells instead of decoding again\n"
+
+              << "  --full-decode   Always decode at full resolution (default: reduce\n"
+              << "                  when the decoder can and the grid is much smaller)\n"
+
+              << "  --live          Low-latency playback: always show the newest frame.\n"
+              << "                  Implied for devices (0, /dev/videoN) and stream URLs;\n"
+              << "                  a file is looped and paced like a camera\n"
+
+              << "  --decode-threads=<n>  Decoder threads [" << MIN_DECODE_THREADS << ", "
+              << MAX_THREADS << "], 0 = backend's choice (default: backend default)\n"
+
+              << "  --backend=<name>      Capture backend: any, ffmpeg, gstreamer, v4l2,\n"
+              << "                        msmf, dshow, avfoundation (default: any)\n"
+
+              << "  --decode-opt=<k>=<v>  Backend option, repeatable: hw_acceleration,\n"
+              << "                        hw_device, open_timeout_msec, read_timeout_msec,\n"
+              << "                        or any FFmpeg option (e.g. rtsp_transport=tcp)\n"
+
+              << "  --resize=<m>    Downscaling: auto, area (exact), pyramid (box\n"
+              << "                  reductions, then area) (default: auto)\n"
+
+              << "  --stats         Print per-stage timings and hardware counters on exit\n"
+
+              << "  --hud           Show a live status line below the frame\n"
+
+              << "  --metrics=<t>   Export Prometheus metrics to a file path or\n"
+              << "                  a loopback [host]:port HTTP endpoint\n"
+
+              << "  --tee=<path>    Also write the frame stream to a file (replay with cat)\n"
+
+              << "  --help          Show this help message\n";
 }
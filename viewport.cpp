@@ -0,0 +1,71 @@
+#include "viewport.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/* --- Helpers --- */
+
+namespace {
+
+constexpr int COORD_BITS = 28;
+constexpr uint64_t COORD_MASK = (uint64_t(1) << COORD_BITS) - 1;
+
+}
+
+/* --- Viewport --- */
+
+Viewport::Viewport(cv::Rect base, cv::Size grid) : base_(base) {
+    sizes_.push_back(base.size());
+    for (int level = 1;; level++) {
+        const double scale = std::pow(ZOOM_STEP, level);
+        const cv::Size size(static_cast<int>(std::lround(base.width / scale)),
+                            static_cast<int>(std::lround(base.height / scale)));
+        if (size.width < grid.width || size.height < grid.height) { break; }
+        sizes_.push_back(size);
+    }
+    state_.store(pack({0, base.width / 2, base.height / 2}), std::memory_order_relaxed);
+}
+
+cv::Rect Viewport::region() const {
+    const State s = unpack(state_.load(std::memory_order_acquire));
+    const cv::Size size = sizes_[s.level];
+    return cv::Rect(base_.x + s.centerX - size.width / 2, base_.y + s.centerY - size.height / 2,
+                    size.width, size.height);
+}
+
+void Viewport::zoom(int levels) {
+    State s = unpack(state_.load(std::memory_order_relaxed));
+    s.level = std::clamp(s.level + levels, 0, static_cast<int>(sizes_.size()) - 1);
+    state_.store(pack(clamped(s)), std::memory_order_release);
+}
+
+void Viewport::pan(int dx, int dy) {
+    State s = unpack(state_.load(std::memory_order_relaxed));
+    const cv::Size size = sizes_[s.level];
+    s.centerX += dx * std::max(1, static_cast<int>(size.width * PAN_STEP));
+    s.centerY += dy * std::max(1, static_cast<int>(size.height * PAN_STEP));
+    state_.store(pack(clamped(s)), std::memory_order_release);
+}
+
+void Viewport::reset() {
+    state_.store(pack({0, base_.width / 2, base_.height / 2}), std::memory_order_release);
+}
+
+Viewport::State Viewport::clamped(State s) const {
+    const cv::Size size = sizes_[s.level];
+    s.centerX = std::clamp(s.centerX, size.width / 2, base_.width - (size.width - size.width / 2));
+    s.centerY = std::clamp(s.centerY, size.height / 2, base_.height - (size.height - size.height / 2));
+    return s;
+}
+
+uint64_t Viewport::pack(State s) {
+    return (static_cast<uint64_t>(s.level) << (2 * COORD_BITS)) |
+           (static_cast<uint64_t>(s.centerX) << COORD_BITS) |
+           static_cast<uint64_t>(s.centerY);
+}
+
+Viewport::State Viewport::unpack(uint64_t bits) {
+    return {static_cast<int>(bits >> (2 * COORD_BITS)),
+            static_cast<int>((bits >> COORD_BITS) & COORD_MASK),
+            static_cast<int>(bits & COORD_MASK)};
+}
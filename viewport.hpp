@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+// The part of each decoded frame that is shown: a base region (the black
+// bar crop, or --roi) zoomed and panned interactively. Zooming keeps the
+// base region's aspect ratio, so the grid never changes, and the shown
+// region is a view into the decoded frame, so zooming in shrinks the resize
+// instead of adding a stage. One thread steers; any number read per frame.
+
+// Each zoom level shows 1/ZOOM_STEP as much of the frame across
+constexpr double ZOOM_STEP = 1.25;
+// Each pan step moves the region by this share of its size
+constexpr double PAN_STEP = 0.125;
+
+class Viewport {
+public:
+    // Zoom stops at one source pixel per cell of `grid`
+    Viewport(cv::Rect base, cv::Size grid);
+
+    // Region to show, inside the base region
+    cv::Rect region() const;
+
+    // Zoom in by `levels` (out if negative), keeping the center
+    void zoom(int levels);
+    // Move by `dx`, `dy` steps (right and down if positive)
+    void pan(int dx, int dy);
+    // Back to the whole base region
+    void reset();
+
+    // Region size at every zoom level, largest first
+    const std::vector<cv::Size>& sizes() const { return sizes_; }
+
+private:
+    struct State {
+        int level;
+        int centerX, centerY;   // Relative to the base region
+    };
+
+    static uint64_t pack(State s);
+    static State unpack(uint64_t bits);
+
+    // Keep the region of `s` inside the base region
+    State clamped(State s) const;
+
+    cv::Rect base_;
+    std::vector<cv::Size> sizes_;
+    // Packed State, so a reader never pairs one level with another's center
+    std::atomic<uint64_t> state_;
+};
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+class Executor;
+
+// Unit of work on an Executor's run queue. Jobs live inside whatever posts
+// them (usually a coroutine frame), so posting never allocates.
+struct Job {
+    void (*run)(Job*) = nullptr;
+};
+
+// Defined in executor.cpp
+Executor* currentExecutor();
+void postJob(Executor* executor, Job* job);
+
+// A coroutine parked on a Waiter (see WaitFor)
+struct WaitNode {
+    void (*wake)(WaitNode*) = nullptr;
+    WaitNode* next = nullptr;
+};
+
+// Spin-then-block wait primitive (an event count) for the lock-free queues.
+// A waiter first polls its condition `spins` times, then sleeps on a futex.
+// The low bit of the futex word records that someone may be asleep; only a
+// notifier that finds it set advances the word and makes the wake syscall,
+// so the fast path is a fence and a load, and a burst of notifications to a
+// thread that has not run yet costs one syscall rather than one each.
+// Coroutines wait through WaitFor instead, which parks them on the same
+// Waiter without holding a thread.
+class Waiter {
+public:
+    static constexpr int DEFAULT_SPINS = 128;
+
+    template <typename Ready>
+    void wait(Ready ready, int spins = DEFAULT_SPINS) {
+        // Spinning only helps when the notifier can run at the same time
+        static const bool multicore = std::thread::hardware_concurrency() > 1;
+        for (int i = 0; multicore && i < spins; i++) {
+            if (ready()) { return; }
+            cpuRelax();
+        }
+        // `ready` may consume what it finds (tryPop), so each true result ends the wait
+        for (;;) {
+            if (ready()) { return; }
+            const uint32_t word = state_.fetch_or(SLEEPING, std::memory_order_seq_cst) | SLEEPING;
+            if (ready()) { return; }
+            sleep(word);
+        }
+    }
+
+    // Wake every sleeping thread and parked coroutine so they re-check their
+    // condition. Call after the state change the waiters are polling for.
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const uint32_t word = state_.load(std::memory_order_relaxed);
+        if (!(word & SLEEPING)) { return; }
+        state_.exchange((word & ~SLEEPING) + 2, std::memory_order_seq_cst);
+        wake();
+
+        WaitNode* node;
+        {
+            std::lock_guard<std::mutex> lock(parkedMutex_);
+            node = parked_;
+            parked_ = nullptr;
+        }
+        while (node) {
+            // The node may be freed as soon as it is woken
+            WaitNode* next = node->next;
+            node->wake(node);
+            node = next;
+        }
+    }
+
+    // WaitFor: add a coroutine to the parked list
+    void park(WaitNode* node) {
+        {
+            std::lock_guard<std::mutex> lock(parkedMutex_);
+            node->next = parked_;
+            parked_ = node;
+        }
+        state_.fetch_or(SLEEPING, std::memory_order_seq_cst);
+    }
+
+    // WaitFor: take a node back. False if notify() already claimed it.
+    bool unpark(WaitNode* node) {
+        std::lock_guard<std::mutex> lock(parkedMutex_);
+        for (WaitNode** link = &parked_; *link; link = &(*link)->next) {
+            if (*link == node) {
+                *link = node->next;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr uint32_t SLEEPING = 1;
+
+    static void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+#ifdef __linux__
+    // Returns at once if the word has already moved on
+    void sleep(uint32_t word) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAIT_PRIVATE,
+                word, nullptr, nullptr, 0);
+    }
+    void wake() {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAKE_PRIVATE,
+                INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    void sleep(uint32_t word) {
+        while (state_.load(std::memory_order_acquire) == word) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    void wake() {}
+#endif
+
+    std::atomic<uint32_t> state_{0};    // Epoch << 1 | SLEEPING
+
+    // Slow path only: touched when a coroutine parks or a notifier finds
+    // the SLEEPING bit set
+    std::mutex parkedMutex_;
+    WaitNode* parked_ = nullptr;
+};
+
+// Coroutine counterpart of Waiter::wait. `co_await WaitFor(waiter, attempt)`
+// calls `attempt()`, which returns a std::optional, until it holds a value,
+// and yields that value. In between, the coroutine is parked on `waiter` and
+// its thread returns to the executor; a notify() reposts it to the executor
+// it was suspended on. Must be awaited from a coroutine running on an
+// Executor.
+template <typename Attempt>
+class WaitFor : private WaitNode, private Job {
+public:
+    using Result = typename std::invoke_result_t<Attempt&>::value_type;
+
+    WaitFor(Waiter& waiter, Attempt attempt) : waiter_(waiter), attempt_(std::move(attempt)) {
+        WaitNode::wake = &WaitFor::onWake;
+        Job::run = &WaitFor::onRun;
+    }
+
+    bool await_ready() {
+        result_ = attempt_();
+        return result_.has_value();
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        executor_ = currentExecutor();
+        return suspend();
+    }
+
+    Result await_resume() { return std::move(*result_); }
+
+private:
+    enum : int { PARKING, PARKED, WOKEN };
+
+    // Park until notified; false means the result is already here and the
+    // coroutine should carry on
+    bool suspend() {
+        for (;;) {
+            state_.store(PARKING, std::memory_order_relaxed);
+            waiter_.park(this);
+            result_ = attempt_();
+            if (result_ && waiter_.unpark(this)) { return false; }
+
+            // A notify that claimed the node while it was parking leaves it
+            // to this thread to carry on or park again
+            if (state_.exchange(PARKED, std::memory_order_seq_cst) != WOKEN) { return true; }
+            if (result_) { return false; }
+        }
+    }
+
+    static void onWake(WaitNode* node) {
+        auto* self = static_cast<WaitFor*>(node);
+        if (self->state_.exchange(WOKEN, std::memory_order_seq_cst) == PARKED) {
+            postJob(self->executor_, static_cast<Job*>(self));
+        }
+    }
+
+    static void onRun(Job* job) {
+        auto* self = static_cast<WaitFor*>(job);
+        if (self->result_ || !self->suspend()) { self->handle_.resume(); }
+    }
+
+    Waiter& waiter_;
+    Attempt attempt_;
+    std::optional<Result> result_;
+    std::coroutine_handle<> handle_;
+    Executor* executor_ = nullptr;
+    std::atomic<int> state_{PARKING};
+};